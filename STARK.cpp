@@ -35,13 +35,14 @@ int main() {
     pclose(pipe);
 
     cout << "Result from Python script:\n" << result << endl;
-    std::vector<std::vector<int>> data;
+    // Cells are signed: instructions such as ADD R1 R0 -5 put negative values in the trace
+    std::vector<std::vector<int64_t>> data;
     std::istringstream full_stream(result);
     std::string line;
     while (std::getline(full_stream, line)) {
         std::istringstream iss(line);
-        std::vector<int> row;
-        int value;
+        std::vector<int64_t> row;
+        int64_t value;
         while (iss >> value) {
             row.push_back(value);
         }
@@ -52,8 +53,17 @@ int main() {
 
     vector<vector<FieldElement> > trace_matrix(data.size(), vector<FieldElement>(data[0].size()));
     for (size_t i = 0; i != data.size(); i++) {
-        for (size_t j = 0; j != data[0].size(); j++) {
-            trace_matrix[i][j] = FieldElement(data[i][j]);
+        bool small = true;
+        for (int64_t cell : data[i]) small = small && cell >= 0 && cell <= UINT32_MAX;
+        if (small) {
+            from_u32<FieldElement>(vector<uint32_t>(data[i].begin(), data[i].end()), trace_matrix[i]);
+            continue;
+        }
+        // -x is p - x, as Field(BigInt) reduces it; the magnitude is taken in unsigned arithmetic
+        // so INT64_MIN does not overflow
+        for (size_t j = 0; j != data[i].size(); j++) {
+            const int64_t cell = data[i][j];
+            trace_matrix[i][j] = cell >= 0 ? FieldElement((size_t)cell) : -FieldElement((size_t)(0 - (uint64_t)cell));
         }
     }
 
@@ -0,0 +1,139 @@
+#ifndef CONVOLUTION_HPP
+#define CONVOLUTION_HPP
+
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+#include "Field.hpp"
+#include "FieldKernels.hpp"
+#include "NTT.hpp"
+
+/*
+    Coefficient-vector products for BasicPolynomial::operator*. multiply() picks the algorithm
+    from the length of the shorter operand:
+
+        schoolbook   up to KARATSUBA_THRESHOLD<F>, output-major with lazy reduction
+        Karatsuba    below NTT_THRESHOLD<F>, in one preallocated scratch arena; a longer operand
+                     is cut into blocks of the shorter one
+        NTT          from there on, when the field has a large enough two-adic subgroup
+*/
+namespace convolution {
+    using std::vector;
+
+    // Crossovers for balanced products of length n on one core, from the poly_mul rows of
+    // bench_field. Schoolbook over a base field reduces once per output through Accumulator and
+    // holds its own up to n = 32; extension elements multiply at full cost and are worth
+    // splitting from n = 4. The NTT pads to a power of two >= 2n - 1 and overtakes Karatsuba at
+    // 128, at 64 over an extension, and already at 64 for Goldilocks, whose cheap multiplies
+    // make the transforms cheap too.
+    template <class F>
+    inline size_t KARATSUBA_THRESHOLD = std::is_same_v<NTT::twiddle_field_t<F>, F> ? 32 : 4;
+    template <class F>
+    inline size_t NTT_THRESHOLD = std::is_same_v<NTT::twiddle_field_t<F>, F> ? 128 : 64;
+    template <>
+    inline size_t NTT_THRESHOLD<GoldilocksElement> = 64;
+
+    // out[0 .. n + m - 2] = a * b
+    template <class F>
+    void schoolbook(std::span<const F> a, std::span<const F> b, std::span<F> out) {
+        const size_t n = a.size(), m = b.size();
+        for (size_t k = 0; k != n + m - 1; k++) {
+            Accumulator<F> acc;
+            for (size_t i = k < m ? 0 : k - m + 1; i != std::min(k + 1, n); i++) {
+                acc.add_product(a[i], b[k - i]);
+            }
+            out[k] = acc.reduce();
+        }
+    }
+
+    // Scratch karatsuba() needs for operands of length n: each level keeps the two half sums
+    // and their product, 4 * ceil(n / 2) elements, and recurses on the upper half
+    template <class F>
+    size_t karatsuba_scratch(size_t n) {
+        size_t total = 0;
+        for (; n > KARATSUBA_THRESHOLD<F>; n -= n / 2) total += 4 * (n - n / 2);
+        return total;
+    }
+
+    // Both operands of length n; out has length 2n - 1. The half products go straight into out
+    // and everything else into scratch (karatsuba_scratch(n) elements), so a whole product
+    // allocates nothing.
+    template <class F>
+    void karatsuba(std::span<const F> a, std::span<const F> b, std::span<F> out, std::span<F> scratch) {
+        const size_t n = a.size();
+        if (n <= KARATSUBA_THRESHOLD<F>) {
+            schoolbook(a, b, out);
+            return;
+        }
+        // a = a0 + x^h a1 with len(a0) = h <= len(a1) = hh
+        const size_t h = n / 2, hh = n - h;
+        std::span<F> z0 = out.first(2 * h - 1), z2 = out.subspan(2 * h, 2 * hh - 1);
+        karatsuba<F>(a.first(h), b.first(h), z0, scratch);
+        karatsuba<F>(a.subspan(h), b.subspan(h), z2, scratch);
+        out[2 * h - 1] = F(0);
+
+        // z1 = (a0 + a1)(b0 + b1) - z0 - z2, added in at x^h
+        std::span<F> sa = scratch.first(hh), sb = scratch.subspan(hh, hh), z1 = scratch.subspan(2 * hh, 2 * hh - 1);
+        std::copy(a.begin() + h, a.end(), sa.begin());
+        std::copy(b.begin() + h, b.end(), sb.begin());
+        kernels::add<F>(sa.first(h), sa.first(h), a.first(h));
+        kernels::add<F>(sb.first(h), sb.first(h), b.first(h));
+        karatsuba<F>(sa, sb, z1, scratch.subspan(4 * hh));
+        kernels::sub<F>(z1.first(2 * h - 1), z1.first(2 * h - 1), z0);
+        kernels::sub<F>(z1, z1, z2);
+        kernels::add<F>(out.subspan(h, 2 * hh - 1), out.subspan(h, 2 * hh - 1), z1);
+    }
+
+    // Cyclic convolution of length N = next power of two >= n + m - 1; the evaluations stay in
+    // bit-reversed order between the two transforms
+    template <class F>
+    void ntt(std::span<const F> a, std::span<const F> b, std::span<F> out) {
+        const size_t len = a.size() + b.size() - 1;
+        size_t N = 1;
+        while (N < len) N <<= 1;
+        vector<F> fa(N, F(0)), fb(N, F(0));
+        std::copy(a.begin(), a.end(), fa.begin());
+        std::copy(b.begin(), b.end(), fb.begin());
+        NTT::forward_to_bit_reversed<F>(fa);
+        NTT::forward_to_bit_reversed<F>(fb);
+        kernels::mul(fa, fa, fb);
+        NTT::inverse_from_bit_reversed<F>(fa);
+        std::copy(fa.begin(), fa.begin() + len, out.begin());
+    }
+
+    template <class F>
+    vector<F> multiply(std::span<const F> a, std::span<const F> b) {
+        if (a.empty() || b.empty()) return {};
+        if (a.size() < b.size()) std::swap(a, b);
+        const size_t n = a.size(), m = b.size();
+        vector<F> out(n + m - 1);
+
+        if (m <= KARATSUBA_THRESHOLD<F>) {
+            schoolbook<F>(a, b, out);
+        } else if (m >= NTT_THRESHOLD<F> && n + m - 1 <= NTT::max_size<F>()) {
+            ntt<F>(a, b, out);
+        } else {
+            // Blocks of a against the whole of b, each a balanced Karatsuba product
+            std::fill(out.begin(), out.end(), F(0));
+            vector<F> block(m), product(2 * m - 1), scratch(karatsuba_scratch<F>(m));
+            for (size_t start = 0; start < n; start += m) {
+                size_t len = std::min(m, n - start);
+                std::fill(block.begin(), block.end(), F(0));
+                std::copy(a.begin() + start, a.begin() + start + len, block.begin());
+                karatsuba<F>(block, b, product, scratch);
+                for (size_t i = 0; i != product.size() && start + i < out.size(); i++) {
+                    out[start + i] = out[start + i] + product[i];
+                }
+            }
+        }
+        return out;
+    }
+
+    template <class F>
+    vector<F> multiply(const vector<F> &a, const vector<F> &b) {
+        return multiply<F>(std::span<const F>(a), std::span<const F>(b));
+    }
+}
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef DIVISION_HPP
+#define DIVISION_HPP
+
+#include <span>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+#include "Field.hpp"
+#include "FieldKernels.hpp"
+#include "Convolution.hpp"
+
+/*
+    Coefficient-vector division with remainder for BasicPolynomial::divided_by. With n the
+    length of the dividend and m that of the divisor, the quotient has k = n - m + 1 terms and
+
+        long division   when k or m - 1 is below NEWTON_THRESHOLD<F>: O(k * m), in place
+        Newton          otherwise: rev(q) = rev(a) * rev(b)^{-1} mod x^k, O(M(n))
+
+    A Divisor keeps the reversed divisor's power-series inverse, so dividing many polynomials
+    by one zerofier pays for the Newton iteration once.
+*/
+namespace division {
+    using std::vector;
+
+    // Measured crossovers for balanced divisions; the AVX multiply kernel behind long division's
+    // axpy makes 32-bit fields much cheaper to divide the schoolbook way
+    template <class F>
+    inline size_t NEWTON_THRESHOLD = kernels::detail::has_vector_mul<F> ? 4096 : 192;
+
+    // Length of a without its trailing zeros
+    template <class F>
+    size_t trimmed_length(std::span<const F> a) {
+        size_t n = a.size();
+        while (n != 0 && a[n - 1] == F(0)) n--;
+        return n;
+    }
+
+    // Schoolbook division of r by b (trimmed, length m >= 1) without allocating: on return
+    // r[0 .. m-2] is the remainder and r[m-1 ..] the quotient
+    template <class F>
+    void long_division(std::span<F> r, std::span<const F> b) {
+        const size_t m = b.size();
+        if (r.size() < m) return;
+        const F lc_inv = b[m - 1].inv();
+        for (size_t k = r.size() - m + 1; k-- != 0;) {
+            const F c = r[k + m - 1] * lc_inv;
+            r[k + m - 1] = c;
+            if (c != F(0)) kernels::axpy<F, F>(r.subspan(k, m - 1), -c, b.first(m - 1));
+        }
+    }
+
+    // g = f^{-1} mod x^k by Newton iteration g <- g * (2 - f * g), doubling the precision each
+    // step; f[0] must be nonzero
+    template <class F>
+    vector<F> reciprocal(std::span<const F> f, size_t k) {
+        vector<F> g{f[0].inv()};
+        for (size_t precision = 1; precision < k;) {
+            precision = std::min(2 * precision, k);
+            vector<F> e = convolution::multiply<F>(f.first(std::min(precision, f.size())), g);
+            e.resize(precision, F(0));
+            for (auto &x : e) x = -x;
+            e[0] = e[0] + F(2);
+            g = convolution::multiply<F>(g, e);
+            g.resize(precision);
+        }
+        g.resize(k, F(0));
+        return g;
+    }
+
+    template <class F>
+    class Divisor {
+        public:
+            // Precomputes the inverse for quotients of up to max_quotient_length terms; longer
+            // quotients compute their own. Defaults to the divisor's length, enough to reduce
+            // anything of up to twice its degree.
+            explicit Divisor(const vector<F> &b, size_t max_quotient_length = 0) : divisor(b) {
+                divisor.resize(trimmed_length<F>(divisor));
+                if (divisor.empty()) {
+                    throw std::invalid_argument("Divisor cannot be zero polynomial");
+                }
+                reversed.assign(divisor.rbegin(), divisor.rend());
+                if (max_quotient_length == 0) max_quotient_length = divisor.size();
+                if (use_newton(max_quotient_length)) inverse = reciprocal<F>(reversed, max_quotient_length);
+            }
+
+            const vector<F> &coeffs() const { return divisor; }
+
+            // a = quotient * divisor + remainder; both outputs are trimmed
+            void divide(std::span<const F> a, vector<F> &quotient, vector<F> &remainder) const {
+                const size_t n = trimmed_length<F>(a), m = divisor.size();
+                if (n < m) {
+                    quotient.clear();
+                    remainder.assign(a.begin(), a.begin() + n);
+                    return;
+                }
+                const size_t k = n - m + 1;
+                if (!use_newton(k)) {
+                    remainder.assign(a.begin(), a.begin() + n);
+                    long_division<F>(remainder, divisor);
+                    quotient.assign(remainder.begin() + (m - 1), remainder.end());
+                } else {
+                    vector<F> top(k);
+                    for (size_t i = 0; i != k; i++) top[i] = a[n - 1 - i];
+                    vector<F> rq = k <= inverse.size()
+                        ? convolution::multiply<F>(top, std::span<const F>(inverse).first(k))
+                        : convolution::multiply<F>(top, reciprocal<F>(reversed, k));
+                    quotient.assign(rq.rend() - k, rq.rend());
+                    vector<F> product = convolution::multiply<F>(quotient, divisor);
+                    remainder.assign(a.begin(), a.begin() + (m - 1));
+                    for (size_t i = 0; i != m - 1; i++) remainder[i] = remainder[i] - product[i];
+                }
+                remainder.resize(m - 1);
+                remainder.resize(trimmed_length<F>(remainder));
+            }
+
+        private:
+            vector<F> divisor, reversed, inverse;
+
+            bool use_newton(size_t k) const {
+                return k >= NEWTON_THRESHOLD<F> && divisor.size() - 1 >= NEWTON_THRESHOLD<F>;
+            }
+    };
+
+    template <class F>
+    void divide(const vector<F> &a, const vector<F> &b, vector<F> &quotient, vector<F> &remainder) {
+        const size_t n = trimmed_length<F>(a), m = trimmed_length<F>(b);
+        Divisor<F>(b, n >= m && m != 0 ? n - m + 1 : 1).divide(a, quotient, remainder);
+    }
+}
+
+#endif
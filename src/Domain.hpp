@@ -0,0 +1,80 @@
+#ifndef DOMAIN_HPP
+#define DOMAIN_HPP
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "Field.hpp"
+
+/*
+    The coset offset * <omega> of a power-of-two size, where omega = primitive_nth_root(size).
+    The power and inverse-power tables are built on first use, and domains are cached
+    process-wide by (offset, size), so repeated proofs and all FRI rounds share one set of tables.
+*/
+template <class F>
+class Domain {
+    public:
+        static std::shared_ptr<const Domain> get(const F& offset, size_t size) {
+            static std::mutex lock;
+            static std::map<std::pair<typename F::limbs_t, size_t>, std::shared_ptr<const Domain> > cache;
+            std::lock_guard<std::mutex> guard(lock);
+            auto& slot = cache[{offset.limbs, size}];
+            if (!slot) slot = std::shared_ptr<const Domain>(new Domain(offset, size));
+            return slot;
+        }
+
+        // The subgroup <omega> itself
+        static std::shared_ptr<const Domain> subgroup(size_t size) {
+            return get(F(1), size);
+        }
+
+        Domain(const Domain&) = delete;
+        Domain& operator=(const Domain&) = delete;
+
+        const F& offset() const { return _offset; }
+        const F& generator() const { return _generator; }
+        size_t size() const { return _size; }
+
+        // offset * omega^i for i < size
+        const vector<F>& elements() const {
+            std::call_once(elements_once, [this] { elements_table = powers(_offset, _generator, _size); });
+            return elements_table;
+        }
+
+        // (offset * omega^i)^{-1} = offset^{-1} * omega^{-i}
+        const vector<F>& inverses() const {
+            std::call_once(inverses_once, [this] { inverses_table = powers(_offset.inv(), _generator.inv(), _size); });
+            return inverses_table;
+        }
+
+        const F& operator[](size_t i) const {
+            return elements()[i % _size];
+        }
+
+        // offset^2 * <omega^2>, the domain of the next FRI layer
+        std::shared_ptr<const Domain> square() const {
+            return get(_offset * _offset, _size / 2);
+        }
+
+    private:
+        F _offset;
+        F _generator;
+        size_t _size;
+        mutable std::once_flag elements_once, inverses_once;
+        mutable vector<F> elements_table, inverses_table;
+
+        Domain(const F& offset, size_t size) : _offset(offset), _generator(F::primitive_nth_root(size)), _size(size) {}
+
+        static vector<F> powers(const F& start, const F& step, size_t n) {
+            vector<F> table(n);
+            F x = start;
+            for (size_t i = 0; i != n; i++) {
+                table[i] = x;
+                x = x * step;
+            }
+            return table;
+        }
+};
+
+#endif
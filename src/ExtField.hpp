@@ -0,0 +1,270 @@
+#ifndef EXTFIELD_HPP
+#define EXTFIELD_HPP
+
+#include <array>
+#include <string>
+#include <iostream>
+#include <type_traits>
+#include "Field.hpp"
+
+using std::string;
+
+/*
+    Binomial extension Base[x] / (x^D - W), with D and W taken from the base field's Params.
+    Elements are stored as coefficients c_0 + c_1 x + ... + c_{D-1} x^{D-1}.
+*/
+template <class Base, size_t D = Base::params::ext_degree>
+class ExtFieldElement {
+    static_assert(D > 1, "extension degree must be at least 2");
+
+    public:
+        using base_field = Base;
+        static constexpr size_t degree = D;
+
+        std::array<Base, D> coeffs;
+
+        ExtFieldElement() : coeffs{} {}
+        ExtFieldElement(const Base& c) : coeffs{} { coeffs[0] = c; }
+        ExtFieldElement(const size_t& v) : ExtFieldElement(Base(v)) {}
+        ExtFieldElement(const std::array<Base, D>& c) : coeffs(c) {}
+        ExtFieldElement(BigInt v) { // base-p digits of v, lowest first; -v is the negation, as in Field(BigInt)
+            if (v < 0) {
+                *this = -ExtFieldElement(-v);
+                return;
+            }
+            const BigInt& p = Base::modulus();
+            for (size_t i = 0; i != D; i++) {
+                coeffs[i] = Base(v % p);
+                v = v / p;
+            }
+        }
+        ExtFieldElement(const string& s) : ExtFieldElement(BigInt(s)) {}
+
+        // Coefficient encodings concatenated, lowest degree first
+        static constexpr size_t num_bytes = D * Base::num_bytes;
+        using bytes_t = std::array<uint8_t, num_bytes>;
+
+        void to_bytes(uint8_t* out) const {
+            for (size_t i = 0; i != D; i++) coeffs[i].to_bytes(out + i * Base::num_bytes);
+        }
+
+        bytes_t to_bytes() const {
+            bytes_t out;
+            to_bytes(out.data());
+            return out;
+        }
+
+        static ExtFieldElement from_bytes(const uint8_t* in) {
+            ExtFieldElement r;
+            for (size_t i = 0; i != D; i++) r.coeffs[i] = Base::from_bytes(in + i * Base::num_bytes);
+            return r;
+        }
+
+        static ExtFieldElement from_bytes(const bytes_t& in) {
+            return from_bytes(in.data());
+        }
+
+        static const Base& nonresidue() {
+            static const Base w = Base(static_cast<size_t>(Base::params::ext_nonresidue));
+            return w;
+        }
+
+        ExtFieldElement operator+(const ExtFieldElement& other) const {
+            ExtFieldElement r;
+            for (size_t i = 0; i != D; i++) r.coeffs[i] = coeffs[i] + other.coeffs[i];
+            return r;
+        }
+
+        ExtFieldElement operator-(const ExtFieldElement& other) const {
+            ExtFieldElement r;
+            for (size_t i = 0; i != D; i++) r.coeffs[i] = coeffs[i] - other.coeffs[i];
+            return r;
+        }
+
+        ExtFieldElement operator-() const {
+            ExtFieldElement r;
+            for (size_t i = 0; i != D; i++) r.coeffs[i] = -coeffs[i];
+            return r;
+        }
+
+        ExtFieldElement operator*(const ExtFieldElement& other) const {
+            const auto& a = coeffs;
+            const auto& b = other.coeffs;
+            const Base& w = nonresidue();
+            ExtFieldElement r;
+            if constexpr (D == 3) { // Karatsuba, 6 base multiplications
+                Base v0 = a[0] * b[0], v1 = a[1] * b[1], v2 = a[2] * b[2];
+                r.coeffs[0] = v0 + w * ((a[1] + a[2]) * (b[1] + b[2]) - v1 - v2);
+                r.coeffs[1] = (a[0] + a[1]) * (b[0] + b[1]) - v0 - v1 + w * v2;
+                r.coeffs[2] = (a[0] + a[2]) * (b[0] + b[2]) - v0 - v2 + v1;
+            } else if constexpr (D == 4) { // two levels of Karatsuba over y = x^2, 9 base multiplications
+                std::array<Base, 3> lo = mul_linear(a[0], a[1], b[0], b[1]);
+                std::array<Base, 3> hi = mul_linear(a[2], a[3], b[2], b[3]);
+                std::array<Base, 3> mid = mul_linear(a[0] + a[2], a[1] + a[3], b[0] + b[2], b[1] + b[3]);
+                for (size_t i = 0; i != 3; i++) mid[i] = mid[i] - lo[i] - hi[i];
+                // lo + mid * x^2 + hi * x^4, then fold x^4 = w
+                Base c[7] = {lo[0], lo[1], lo[2] + mid[0], mid[1], mid[2] + hi[0], hi[1], hi[2]};
+                for (size_t i = 0; i != 4; i++) r.coeffs[i] = i + 4 < 7 ? c[i] + w * c[i + 4] : c[i];
+            } else {
+                Base c[2 * D - 1] = {};
+                for (size_t i = 0; i != D; i++) {
+                    for (size_t j = 0; j != D; j++) c[i + j] = c[i + j] + a[i] * b[j];
+                }
+                for (size_t i = 0; i != D; i++) r.coeffs[i] = i + D < 2 * D - 1 ? c[i] + w * c[i + D] : c[i];
+            }
+            return r;
+        }
+
+        // Mixed arithmetic with the base field, so base codewords never need to be promoted
+        ExtFieldElement operator+(const Base& other) const {
+            ExtFieldElement r = *this;
+            r.coeffs[0] = r.coeffs[0] + other;
+            return r;
+        }
+
+        ExtFieldElement operator-(const Base& other) const {
+            ExtFieldElement r = *this;
+            r.coeffs[0] = r.coeffs[0] - other;
+            return r;
+        }
+
+        ExtFieldElement operator*(const Base& other) const {
+            ExtFieldElement r;
+            for (size_t i = 0; i != D; i++) r.coeffs[i] = coeffs[i] * other;
+            return r;
+        }
+
+        friend ExtFieldElement operator+(const Base& a, const ExtFieldElement& b) { return b + a; }
+        friend ExtFieldElement operator-(const Base& a, const ExtFieldElement& b) { return -b + a; }
+        friend ExtFieldElement operator*(const Base& a, const ExtFieldElement& b) { return b * a; }
+
+        // x -> x^p, which acts on the basis as x^i -> gamma_i x^i with gamma_i = W^(i (p - 1) / D)
+        ExtFieldElement frobenius() const {
+            const auto& gamma = frobenius_coeffs();
+            ExtFieldElement r;
+            for (size_t i = 0; i != D; i++) r.coeffs[i] = coeffs[i] * gamma[i];
+            return r;
+        }
+
+        // a^{-1} = (a^p a^{p^2} ... a^{p^{D-1}}) / N(a), where the norm N(a) lies in the base field
+        ExtFieldElement inv() const {
+            ExtFieldElement prod = ExtFieldElement(Base(1));
+            ExtFieldElement conj = *this;
+            for (size_t k = 1; k != D; k++) {
+                conj = conj.frobenius();
+                prod = prod * conj;
+            }
+            Base norm = coeffs[0] * prod.coeffs[0];
+            Base wrapped = Base(0);
+            for (size_t i = 1; i != D; i++) wrapped = wrapped + coeffs[i] * prod.coeffs[D - i];
+            norm = norm + nonresidue() * wrapped;
+            return prod * norm.inv();
+        }
+
+        ExtFieldElement operator/(const ExtFieldElement& other) const {
+            return *this * other.inv();
+        }
+
+        ExtFieldElement operator^(unsigned long long exp) const {
+            ExtFieldElement result = ExtFieldElement(Base(1));
+            ExtFieldElement base = *this;
+            while (exp != 0) {
+                if (exp & 1) result = result * base;
+                base = base * base;
+                exp >>= 1;
+            }
+            return result;
+        }
+
+        bool operator==(const ExtFieldElement& other) const {
+            return coeffs == other.coeffs;
+        }
+
+        bool operator!=(const ExtFieldElement& other) const {
+            return coeffs != other.coeffs;
+        }
+
+        operator string() const {
+            string result = "(";
+            for (size_t i = 0; i != D; i++) {
+                if (i != 0) result += ", ";
+                result += (string)coeffs[i];
+            }
+            return result + ")";
+        }
+
+        friend std::ostream& operator<<(std::ostream& os, const ExtFieldElement& x) {
+            os << (string)x;
+            return os;
+        }
+
+    private:
+        static std::array<Base, 3> mul_linear(const Base& a0, const Base& a1, const Base& b0, const Base& b1) {
+            Base lo = a0 * b0, hi = a1 * b1;
+            return {lo, (a0 + a1) * (b0 + b1) - lo - hi, hi};
+        }
+
+        static const std::array<Base, D>& frobenius_coeffs() {
+            static const std::array<Base, D> gamma = [] {
+                std::array<Base, D> g;
+                Base step = nonresidue() ^ ((Base::modulus() - 1) / BigInt(static_cast<ttmath::uint>(D)));
+                g[0] = Base(1);
+                for (size_t i = 1; i != D; i++) g[i] = g[i - 1] * step;
+                return g;
+            }();
+            return gamma;
+        }
+};
+
+// Coefficient-wise lazy accumulation. Products of two extension elements are expanded with
+// the wrapped terms pre-multiplied by W, so every base product lands in an unreduced sum.
+template <class Base, size_t D>
+class Accumulator<ExtFieldElement<Base, D> > {
+    using E = ExtFieldElement<Base, D>;
+
+    public:
+        void add_product(const E& a, const Base& b) {
+            for (size_t i = 0; i != D; i++) acc[i].add_product(a.coeffs[i], b);
+        }
+
+        void add_product(const E& a, const E& b) {
+            std::array<Base, D> wrapped;
+            for (size_t i = 0; i != D; i++) wrapped[i] = E::nonresidue() * a.coeffs[i];
+            for (size_t i = 0; i != D; i++) {
+                for (size_t j = 0; j != D; j++) {
+                    if (i + j < D) acc[i + j].add_product(a.coeffs[i], b.coeffs[j]);
+                    else acc[i + j - D].add_product(wrapped[i], b.coeffs[j]);
+                }
+            }
+        }
+
+        void add(const E& a) {
+            for (size_t i = 0; i != D; i++) acc[i].add(a.coeffs[i]);
+        }
+
+        E reduce() const {
+            E r;
+            for (size_t i = 0; i != D; i++) r.coeffs[i] = acc[i].reduce();
+            return r;
+        }
+
+    private:
+        std::array<Accumulator<Base>, D> acc;
+};
+
+template <class F, bool = (F::params::ext_degree > 1)>
+struct challenge_field {
+    using type = F;
+};
+
+template <class F>
+struct challenge_field<F, true> {
+    using type = ExtFieldElement<F>;
+};
+
+// Field verifier challenges are sampled from: the base field itself when it is large enough,
+// otherwise the extension named by its Params
+template <class F>
+using ChallengeField = typename challenge_field<F>::type;
+
+#endif
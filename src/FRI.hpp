@@ -1,8 +1,11 @@
 #ifndef FRI_HPP
 #define FRI_HPP
 
+#include <type_traits>
 #include "Field.hpp"
 #include "Polynomial.hpp"
+#include "FieldKernels.hpp"
+#include "Domain.hpp"
 #include "merklecpp.h"
 namespace FRI {
     class FRI {
@@ -20,69 +23,100 @@ namespace FRI {
         return rounds;
     }
 
-    void prove(const vector<FieldElement> &codeword, 
-        const FieldElement &_omega,
-        const FieldElement &_offset,
+    // One folding round: commits the current codeword, folds it with an extension-field
+    // challenge and opens the colinearity checks. The codeword may still be over the base
+    // field F; only the folded codeword is over E, so the base codeword is never promoted
+    // for the arithmetic.
+    template <class F, class E, class C>
+    vector<E> prove_round(const vector<C> &cur_codeword,
+        const Domain<F> &domain,
         void (*commit)(void*), 
         void (*get_challenge)(void*), 
         void (*get_colinearity_challenge)(void*),
         void (*open_merkle)(void*)) {
-            size_t domain_length = codeword.size();
-            size_t rounds = num_rounds(domain_length);
-            vector<FieldElement> cur_codeword = codeword;
-            vector<FieldElement> folded_codeword;
-
-            FieldElement omega = _omega;
-            FieldElement offset = _offset;
-            // Without use of merkle tree, temporary workaround
-            for (size_t i = 0; i != rounds; i++) {
+            size_t domain_length = cur_codeword.size();
+            if constexpr (std::is_same_v<C, E>) {
                 commit((void*)&cur_codeword);
-                FieldElement challenge;
-                get_challenge((void*)&challenge);
-                for (size_t j = 0; j != cur_codeword.size() / 2; j++) {
-                    folded_codeword.push_back(
-                        FieldElement(2).inv() * (
-                            (FieldElement(1) + challenge / (offset * (omega^j))) * cur_codeword[j] + 
-                            (FieldElement(1) - challenge / (offset * (omega^j))) * cur_codeword[j + domain_length / 2]
-                        )
-                    );
-                }
-                commit((void*)&folded_codeword);
-                for (size_t j = 0; j != num_colinearity_checks; j++) {
-                    size_t index;
-                    get_colinearity_challenge((void*)&index);
-                    assert(index != 0);
-                    vector<FieldElement> colinearity_points_x;
-                    vector<FieldElement> colinearity_points_y;
-                    colinearity_points_x.push_back((offset * (omega^index)));
-                    colinearity_points_y.push_back(cur_codeword[index]);
+            } else {
+                vector<E> committed(cur_codeword.begin(), cur_codeword.end());
+                commit((void*)&committed);
+            }
+            E challenge;
+            get_challenge((void*)&challenge);
 
-                    colinearity_points_x.push_back((offset * (omega^(index + domain_length / 2))));
-                    colinearity_points_y.push_back(cur_codeword[index + domain_length / 2]);
+            // 1/2 [(1 + c/x) a + (1 - c/x) b] = (a + b)/2 + c (a - b)/(2x)
+            size_t half = domain_length / 2;
+            vector<F> twiddle(half);
+            kernels::scalar_mul<F>(twiddle, std::span<const F>(domain.inverses().data(), half), F(2).inv());
+            std::span<const C> lo(cur_codeword.data(), half), hi(cur_codeword.data() + half, half);
+            vector<C> even(half), odd(half);
+            kernels::add<C>(even, lo, hi);
+            kernels::sub<C>(odd, lo, hi);
+            kernels::scalar_mul(even, even, F(2).inv());
+            kernels::mul(odd, odd, twiddle);
+            vector<E> folded_codeword(even.begin(), even.end());
+            kernels::axpy(folded_codeword, challenge, odd);
+            commit((void*)&folded_codeword);
 
-                    colinearity_points_x.push_back((challenge));
-                    colinearity_points_y.push_back(folded_codeword[index]);
-                    
-                    vector<FieldElement> open(6, FieldElement(0));
-                    for (size_t k = 0; k != colinearity_points_x.size(); k++) {
-                        open[k] = colinearity_points_x[k];
-                        open[k + 3] = colinearity_points_y[k];
-                    }
-                    open_merkle((void*)&open); // Placeholder, now the verifier could check it themselves
-                }
+            for (size_t j = 0; j != num_colinearity_checks; j++) {
+                size_t index;
+                get_colinearity_challenge((void*)&index);
+                assert(index != 0);
+                vector<E> colinearity_points_x;
+                vector<E> colinearity_points_y;
+                colinearity_points_x.push_back(E(domain[index]));
+                colinearity_points_y.push_back(E(cur_codeword[index]));
 
-                cur_codeword = folded_codeword;
-                folded_codeword.clear();
-                domain_length = domain_length / 2;
-                offset = (offset^2);
-                omega = omega * omega;
+                colinearity_points_x.push_back(E(domain[index + domain_length / 2]));
+                colinearity_points_y.push_back(E(cur_codeword[index + domain_length / 2]));
 
-                vector<FieldElement> new_domain;
-                for (size_t j = 0; j != cur_codeword.size(); j++) {
-                    new_domain.push_back(offset * omega^j);
+                colinearity_points_x.push_back((challenge));
+                colinearity_points_y.push_back(folded_codeword[index]);
+                
+                vector<E> open(6, E(0));
+                for (size_t k = 0; k != colinearity_points_x.size(); k++) {
+                    open[k] = colinearity_points_x[k];
+                    open[k + 3] = colinearity_points_y[k];
                 }
+                open_merkle((void*)&open); // Placeholder, now the verifier could check it themselves
+            }
+            return folded_codeword;
+        }
+
+    // Challenges are sampled from E (ChallengeField<F> for small base fields); the input
+    // codeword may be over F or E
+    template <class F, class E = F, class C>
+    void prove(const vector<C> &codeword,
+        std::shared_ptr<const Domain<F> > domain,
+        void (*commit)(void*), 
+        void (*get_challenge)(void*), 
+        void (*get_colinearity_challenge)(void*),
+        void (*open_merkle)(void*)) {
+            assert(domain->size() == codeword.size());
+            size_t rounds = num_rounds(codeword.size());
+            if (rounds == 0) return;
+
+            // Without use of merkle tree, temporary workaround
+            vector<E> cur_codeword = prove_round<F, E>(codeword, *domain, commit, get_challenge, get_colinearity_challenge, open_merkle);
+            for (size_t i = 1; i != rounds; i++) {
+                domain = domain->square();
+                cur_codeword = prove_round<F, E>(cur_codeword, *domain, commit, get_challenge, get_colinearity_challenge, open_merkle);
             }
         }
+
+    // omega must be primitive_nth_root(codeword.size()), the generator of the cached domain
+    template <class F, class E = F, class C>
+    void prove(const vector<C> &codeword, 
+        const F &omega,
+        const F &offset,
+        void (*commit)(void*), 
+        void (*get_challenge)(void*), 
+        void (*get_colinearity_challenge)(void*),
+        void (*open_merkle)(void*)) {
+            auto domain = Domain<F>::get(offset, codeword.size());
+            assert(domain->generator() == omega);
+            prove<F, E>(codeword, domain, commit, get_challenge, get_colinearity_challenge, open_merkle);
+        }
 }
 
 #endif
\ No newline at end of file
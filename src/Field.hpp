@@ -6,6 +6,9 @@
 #include <string>
 #include <cassert>
 #include <vector>
+#include <array>
+#include <span>
+#include <stdexcept>
 #include "ttmath/ttmath.h"
 #include "merklecpp.h"
 #include <openssl/sha.h>
@@ -18,164 +21,592 @@ using ttmath::Int;
 #define BigInt Int<32>
 #define ull unsigned long long
 
-const BigInt P = "270497897142230380135924736767050121217"; // 1 + 407 * ( 1 << 119 )
-// const BigInt P = "17"; // testing prime
-
-void xgcd(BigInt x, BigInt y, BigInt &a, BigInt &b, BigInt &g) { // Extended Euclidean algorithm
-    BigInt old_r = x;
-    BigInt r = y;
-    BigInt old_s = 1;
-    BigInt s = 0;
-    BigInt old_t = 0;
-    BigInt t = 1;
-
-    // std::cout << "XGCD: " << x << ", " << y << std::endl;
-
-    while (r != 0) {
-        BigInt quotient = old_r / r;
-        BigInt temp_r = r;
-        r = old_r - quotient * r;
-        old_r = temp_r;
-
-        BigInt temp_s = s;
-        s = old_s - quotient * s;
-        old_s = temp_s;
-
-        BigInt temp_t = t;
-        t = old_t - quotient * t;
-        old_t = temp_t;
-        // std::cout << old_r << ", " << old_s << ", " << old_t << std::endl;
-        // std::cout << r << ", " << s << ", " << t << std::endl;
+/*
+    Field parameters. Each prime field is described by a Params struct:
+        word          limb type (uint32_t or uint64_t)
+        limbs         number of little-endian limbs, R = 2^(bits(word) * limbs)
+        modulus       the prime, canonical limbs
+        two_adicity   largest k such that 2^k divides p - 1
+        generator     coset offset used by the prover
+        two_adic_root element of order exactly 2^two_adicity
+        ext_degree    degree D of the extension verifier challenges are drawn from (1 = base field)
+        ext_nonresidue W such that x^D - W is irreducible, defining the extension
+*/
+struct P128Params { // 1 + 407 * 2^119
+    using word = uint64_t;
+    static constexpr size_t limbs = 2;
+    static constexpr std::array<word, limbs> modulus = {1ULL, 407ULL << 55};
+    static constexpr size_t two_adicity = 119;
+    // 85408008396924667383611388730472331217, order 2^119
+    static constexpr std::array<word, limbs> generator = {0xb5038f9c18f6f7d1ULL, 0x4040fbed12ee470fULL};
+    static constexpr std::array<word, limbs> two_adic_root = generator;
+    static constexpr size_t ext_degree = 1;
+    static constexpr uint64_t ext_nonresidue = 0;
+};
+
+struct GoldilocksParams { // 2^64 - 2^32 + 1
+    using word = uint64_t;
+    static constexpr size_t limbs = 1;
+    static constexpr std::array<word, limbs> modulus = {0xffffffff00000001ULL};
+    static constexpr size_t two_adicity = 32;
+    static constexpr std::array<word, limbs> generator = {7};
+    static constexpr std::array<word, limbs> two_adic_root = {1753635133440165772ULL}; // 7^((p - 1) / 2^32)
+    static constexpr size_t ext_degree = 3;
+    static constexpr uint64_t ext_nonresidue = 7; // not a cube
+};
+
+struct BabyBearParams { // 15 * 2^27 + 1
+    using word = uint32_t;
+    static constexpr size_t limbs = 1;
+    static constexpr std::array<word, limbs> modulus = {0x78000001U};
+    static constexpr size_t two_adicity = 27;
+    static constexpr std::array<word, limbs> generator = {31};
+    static constexpr std::array<word, limbs> two_adic_root = {440564289U}; // 31^15
+    static constexpr size_t ext_degree = 4;
+    static constexpr uint64_t ext_nonresidue = 11; // not a square, p = 1 mod 4
+};
+
+namespace montgomery {
+    // Fixed-width arithmetic on little-endian limbs, R = 2^(WORD_BITS * limbs).
+    // Everything here is constexpr so the Montgomery constants are computed at compile time.
+    template <class Word> struct dword;
+    template <> struct dword<uint32_t> { using type = uint64_t; };
+    template <> struct dword<uint64_t> { using type = unsigned __int128; };
+
+    template <class Params> using word_t = typename Params::word;
+    template <class Params> using dword_t = typename dword<word_t<Params> >::type;
+    template <class Params> using limbs_t = std::array<word_t<Params>, Params::limbs>;
+    template <class Params> constexpr size_t WORD_BITS = 8 * sizeof(word_t<Params>);
+
+    template <class Params>
+    constexpr bool geq(const limbs_t<Params>& a, const limbs_t<Params>& b) {
+        for (size_t i = Params::limbs; i-- > 0;) {
+            if (a[i] != b[i]) return a[i] > b[i];
+        }
+        return true;
+    }
+
+    // a += b, returns the carry out of the top limb
+    template <class Params>
+    constexpr word_t<Params> add_in_place(limbs_t<Params>& a, const limbs_t<Params>& b) {
+        using W = word_t<Params>;
+        using D = dword_t<Params>;
+        W carry = 0;
+        for (size_t i = 0; i != Params::limbs; i++) {
+            D s = (D)a[i] + b[i] + carry;
+            a[i] = (W)s;
+            carry = (W)(s >> WORD_BITS<Params>);
+        }
+        return carry;
+    }
+
+    // a -= b, returns the borrow out of the top limb
+    template <class Params>
+    constexpr word_t<Params> sub_in_place(limbs_t<Params>& a, const limbs_t<Params>& b) {
+        using W = word_t<Params>;
+        using D = dword_t<Params>;
+        W borrow = 0;
+        for (size_t i = 0; i != Params::limbs; i++) {
+            D d = (D)a[i] - b[i] - borrow;
+            a[i] = (W)d;
+            borrow = (W)(d >> WORD_BITS<Params>) & 1;
+        }
+        return borrow;
+    }
+
+    template <class Params>
+    constexpr limbs_t<Params> add_mod(limbs_t<Params> a, const limbs_t<Params>& b) {
+        auto carry = add_in_place<Params>(a, b);
+        if (carry || geq<Params>(a, Params::modulus)) sub_in_place<Params>(a, Params::modulus);
+        return a;
+    }
+
+    template <class Params>
+    constexpr limbs_t<Params> sub_mod(limbs_t<Params> a, const limbs_t<Params>& b) {
+        if (sub_in_place<Params>(a, b)) add_in_place<Params>(a, Params::modulus);
+        return a;
+    }
+
+    // -p^{-1} mod 2^WORD_BITS by Newton iteration, each step doubles the number of correct bits
+    template <class Params>
+    constexpr word_t<Params> neg_inv() {
+        using W = word_t<Params>;
+        W p0 = Params::modulus[0];
+        W x = 1;
+        for (size_t i = 0; i != 6; i++) x *= (W)(2 - p0 * x);
+        return (W)(~x + 1);
+    }
+
+    template <class Params>
+    constexpr limbs_t<Params> pow2_mod(size_t k) {
+        limbs_t<Params> r = {1};
+        for (size_t i = 0; i != k; i++) r = add_mod<Params>(r, r);
+        return r;
+    }
+
+    template <class Params>
+    struct constants {
+        static constexpr size_t R_BITS = WORD_BITS<Params> * Params::limbs;
+        static constexpr word_t<Params> N_PRIME = neg_inv<Params>();
+        static constexpr limbs_t<Params> R_MOD_P = pow2_mod<Params>(R_BITS);       // Montgomery form of 1
+        static constexpr limbs_t<Params> R2_MOD_P = pow2_mod<Params>(2 * R_BITS);  // used to enter Montgomery form
+    };
+
+    // CIOS Montgomery multiplication: returns a * b * R^{-1} mod p
+    template <class Params>
+    constexpr limbs_t<Params> mul(const limbs_t<Params>& a, const limbs_t<Params>& b) {
+        using W = word_t<Params>;
+        using D = dword_t<Params>;
+        constexpr size_t N = Params::limbs;
+        constexpr size_t BITS = WORD_BITS<Params>;
+        W t[N + 2] = {};
+        for (size_t i = 0; i != N; i++) {
+            W carry = 0;
+            for (size_t j = 0; j != N; j++) {
+                D s = (D)a[j] * b[i] + t[j] + carry;
+                t[j] = (W)s;
+                carry = (W)(s >> BITS);
+            }
+            D s = (D)t[N] + carry;
+            t[N] = (W)s;
+            t[N + 1] = (W)(s >> BITS);
+
+            W m = (W)(t[0] * constants<Params>::N_PRIME);
+            s = (D)m * Params::modulus[0] + t[0];
+            carry = (W)(s >> BITS);
+            for (size_t j = 1; j != N; j++) {
+                s = (D)m * Params::modulus[j] + t[j] + carry;
+                t[j - 1] = (W)s;
+                carry = (W)(s >> BITS);
+            }
+            s = (D)t[N] + carry;
+            t[N - 1] = (W)s;
+            t[N] = t[N + 1] + (W)(s >> BITS);
+        }
+        limbs_t<Params> r = {};
+        for (size_t i = 0; i != N; i++) r[i] = t[i];
+        if (t[N] || geq<Params>(r, Params::modulus)) sub_in_place<Params>(r, Params::modulus);
+        return r;
     }
 
-    a = old_s;
-    b = old_t;
-    g = old_r;
-    return;
+    template <class Params>
+    constexpr limbs_t<Params> to_mont(const limbs_t<Params>& a) { return mul<Params>(a, constants<Params>::R2_MOD_P); }
+
+    template <class Params>
+    constexpr limbs_t<Params> from_mont(const limbs_t<Params>& a) { return mul<Params>(a, limbs_t<Params>{1}); }
+
+    // Canonical limbs of a 64-bit integer, reduced when the modulus is narrower than 64 bits
+    template <class Params>
+    constexpr limbs_t<Params> u64_to_limbs(uint64_t v) {
+        using W = word_t<Params>;
+        constexpr size_t BITS = WORD_BITS<Params>;
+        if constexpr (BITS * Params::limbs <= 64) {
+            uint64_t p = 0;
+            for (size_t i = 0; i != Params::limbs; i++) p |= (uint64_t)Params::modulus[i] << (i * BITS);
+            v %= p;
+        }
+        limbs_t<Params> out = {};
+        for (size_t i = 0; i != Params::limbs && i * BITS < 64; i++) out[i] = (W)(v >> (i * BITS));
+        return out;
+    }
+
+    // Copies the low bits of a non-negative BigInt into limbs and back, chunked by the narrower word size
+    template <class Params>
+    limbs_t<Params> bigint_to_limbs(const BigInt& r) {
+        using W = word_t<Params>;
+        constexpr size_t BITS = WORD_BITS<Params>;
+        constexpr size_t CHUNK = BITS < TTMATH_BITS_PER_UINT ? BITS : TTMATH_BITS_PER_UINT;
+        limbs_t<Params> out = {};
+        for (size_t bit = 0; bit < BITS * Params::limbs; bit += CHUNK) {
+            W chunk = (W)(r.table[bit / TTMATH_BITS_PER_UINT] >> (bit % TTMATH_BITS_PER_UINT));
+            out[bit / BITS] |= chunk << (bit % BITS);
+        }
+        return out;
+    }
+
+    template <class Params>
+    BigInt limbs_to_bigint(const limbs_t<Params>& a) {
+        constexpr size_t BITS = WORD_BITS<Params>;
+        constexpr size_t CHUNK = BITS < TTMATH_BITS_PER_UINT ? BITS : TTMATH_BITS_PER_UINT;
+        BigInt r = 0;
+        for (size_t bit = 0; bit < BITS * Params::limbs; bit += CHUNK) {
+            ttmath::uint chunk = (ttmath::uint)(a[bit / BITS] >> (bit % BITS));
+            if (CHUNK < TTMATH_BITS_PER_UINT) chunk &= ((ttmath::uint)1 << CHUNK) - 1;
+            r.table[bit / TTMATH_BITS_PER_UINT] |= chunk << (bit % TTMATH_BITS_PER_UINT);
+        }
+        return r;
+    }
 }
 
-class FieldElement {
+template <class Params>
+class Field {
     public:
-        BigInt value;
-    
-        FieldElement(BigInt v = 0) : value((v + P) % P) {}
-        FieldElement(const size_t& v) {
-            value = BigInt(static_cast<ttmath::ulint>(v));
-            value = (value + P) % P;
+        using params = Params;
+        using limbs_t = montgomery::limbs_t<Params>;
+
+        limbs_t limbs; // Montgomery form, always fully reduced
+
+        Field() : limbs{} {}
+        Field(BigInt v) {
+            BigInt r = v % modulus();
+            if (r < 0) r += modulus();
+            limbs = montgomery::to_mont<Params>(montgomery::bigint_to_limbs<Params>(r));
         }
-        FieldElement(const string& s) {
-            value = BigInt(s);
-            value = (value + P) % P;
+        Field(const size_t& v) {
+            limbs = v <= UINT32_MAX ? from_small((uint32_t)v).limbs : montgomery::to_mont<Params>(montgomery::u64_to_limbs<Params>(v));
         }
+        Field(const string& s) : Field(BigInt(s)) {}
 
-        FieldElement operator+(const FieldElement& other) const {
-            BigInt res = value + other.value;
-            if (res >= P) res -= P;
-            return FieldElement(res);
+        static Field from_montgomery(const limbs_t& l) {
+            Field r;
+            r.limbs = l;
+            return r;
         }
 
-        FieldElement operator-(const FieldElement& other) const {
-            return FieldElement((value + P - other.value) % P);
+        // Small non-negative values (trace cells, register contents). For multi-limb fields the
+        // Montgomery form of each byte position is tabulated, so this is table lookups and
+        // modular additions only
+        static Field from_small(uint32_t v) {
+            if constexpr (Params::limbs == 1) { // v < R, so a single Montgomery multiplication is cheaper
+                return from_montgomery(montgomery::mul<Params>(limbs_t{(typename Params::word)v}, montgomery::constants<Params>::R2_MOD_P));
+            }
+            const auto& t = small_tables();
+            limbs_t r = t[0][v & 0xff];
+            for (size_t k = 1; k != 4 && (v >>= 8) != 0; k++) r = montgomery::add_mod<Params>(r, t[k][v & 0xff]);
+            return from_montgomery(r);
         }
 
-        FieldElement operator*(const FieldElement& other) const {
-            return FieldElement((value * other.value) % P);
+        static Field from_small(uint16_t v) {
+            if constexpr (Params::limbs == 1) return from_small((uint32_t)v);
+            const auto& t = small_tables();
+            return from_montgomery(montgomery::add_mod<Params>(t[0][v & 0xff], t[1][v >> 8]));
         }
 
-        FieldElement operator/(const FieldElement& other) const {
-            assert(other.value != 0);
-            BigInt a, b, g;
-            xgcd(other.value, P, a, b, g);
-            return FieldElement(value * a % P);
+        static const BigInt& modulus() {
+            static const BigInt p = montgomery::limbs_to_bigint<Params>(Params::modulus);
+            return p;
         }
 
-        FieldElement operator%(const FieldElement& other) const {
-            return FieldElement(value % other.value);
+        static Field generator() {
+            return from_montgomery(montgomery::to_mont<Params>(Params::generator));
         }
 
-        FieldElement operator-() const {
-            return FieldElement((P - value) % P);
+        // Roots for every power-of-two order are squared down from two_adic_root once
+        static Field primitive_nth_root(uint64_t n) {
+            static const std::array<Field, 64> roots = [] {
+                std::array<Field, 64> r;
+                Field root = from_montgomery(montgomery::to_mont<Params>(Params::two_adic_root));
+                size_t log_order = Params::two_adicity;
+                for (; log_order > 63; log_order--) root = root * root;
+                for (size_t k = log_order + 1; k-- > 0;) {
+                    r[k] = root;
+                    root = root * root;
+                }
+                return r;
+            }();
+            assert(n != 0 && (n & (n - 1)) == 0);
+            assert(n <= (1ULL << std::min<size_t>(Params::two_adicity, 63)));
+            return roots[__builtin_ctzll(n)];
         }
 
-        FieldElement inv() const {
-            BigInt a, b, g;
-            xgcd(value, P, a, b, g);
-            return FieldElement(a);
+        BigInt to_bigint() const {
+            return montgomery::limbs_to_bigint<Params>(montgomery::from_mont<Params>(limbs));
         }
 
-        FieldElement operator^(const FieldElement& other) const {
-            return this->operator^(other.value);
+        // Canonical little-endian encoding of the reduced value, one word after another
+        static constexpr size_t num_bytes = sizeof(limbs_t);
+        using bytes_t = std::array<uint8_t, num_bytes>;
+
+        void to_bytes(uint8_t* out) const {
+            limbs_t canonical = montgomery::from_mont<Params>(limbs);
+            for (size_t i = 0; i != num_bytes; i++) {
+                out[i] = (uint8_t)(canonical[i / sizeof(typename Params::word)] >> (8 * (i % sizeof(typename Params::word))));
+            }
         }
 
-        FieldElement operator^(BigInt exp) const {
-            BigInt zero = 0;
-            if (exp == 0) return FieldElement(1);
-            if (exp == 1) return FieldElement(value);
-            FieldElement result(1);
-            FieldElement base(value);
+        bytes_t to_bytes() const {
+            bytes_t out;
+            to_bytes(out.data());
+            return out;
+        }
 
-            while (exp != zero && base != FieldElement(1)) {
-                if (exp % 2 == 1) result = result * base;
-                base = base * base;
-                exp = exp >> 1;
+        static Field from_bytes(const uint8_t* in) {
+            limbs_t canonical = {};
+            for (size_t i = 0; i != num_bytes; i++) {
+                canonical[i / sizeof(typename Params::word)] |= (typename Params::word)in[i] << (8 * (i % sizeof(typename Params::word)));
             }
-            return result;
+            if (montgomery::geq<Params>(canonical, Params::modulus)) {
+                throw std::invalid_argument("Encoding is not a canonical field element");
+            }
+            return from_montgomery(montgomery::to_mont<Params>(canonical));
+        }
+
+        static Field from_bytes(const bytes_t& in) {
+            return from_bytes(in.data());
+        }
+
+        Field operator+(const Field& other) const {
+            return from_montgomery(montgomery::add_mod<Params>(limbs, other.limbs));
+        }
+
+        Field operator-(const Field& other) const {
+            return from_montgomery(montgomery::sub_mod<Params>(limbs, other.limbs));
         }
 
-        FieldElement operator^(unsigned long long exp) const {
-            BigInt _exp = static_cast<ttmath::ulint>(exp);
-            return this->operator^(_exp);
+        Field operator*(const Field& other) const {
+            return from_montgomery(montgomery::mul<Params>(limbs, other.limbs));
         }
 
-        bool operator==(const FieldElement& other) const {
-            return value == other.value;
+        Field operator/(const Field& other) const {
+            assert(other != Field(0));
+            return *this * other.inv();
         }
 
-        bool operator!=(const FieldElement& other) const {
-            return value != other.value;
+        Field operator%(const Field& other) const {
+            return Field(to_bigint() % other.to_bigint());
+        }
+
+        Field operator-() const {
+            return from_montgomery(montgomery::sub_mod<Params>(limbs_t{}, limbs));
+        }
+
+        Field inv() const { // Fermat: x^(p - 2)
+            limbs_t e = Params::modulus;
+            montgomery::sub_in_place<Params>(e, limbs_t{2});
+            uint64_t words[EXP_WORDS] = {};
+            for (size_t i = 0; i != Params::limbs; i++) {
+                size_t bit = i * montgomery::WORD_BITS<Params>;
+                words[bit / 64] |= (uint64_t)e[i] << (bit % 64);
+            }
+            return pow_words(words, EXP_WORDS);
+        }
+
+        Field operator^(const Field& other) const {
+            return this->operator^(other.to_bigint());
+        }
+
+        Field operator^(BigInt exp) const {
+            if (exp < 0) return inv() ^ (-exp); // x^-e = (x^-1)^e
+            uint64_t words[(TTMATH_BITS_PER_UINT * 32 + 63) / 64] = {};
+            const size_t n_words = sizeof(words) / sizeof(words[0]);
+            for (size_t w = 0; w != 32; w++) {
+                words[w * TTMATH_BITS_PER_UINT / 64] |= (uint64_t)exp.table[w] << (w * TTMATH_BITS_PER_UINT % 64);
+            }
+            return pow_words(words, n_words);
+        }
+
+        Field operator^(unsigned long long exp) const {
+            uint64_t e = exp;
+            return pow_words(&e, 1);
+        }
+
+        bool operator==(const Field& other) const {
+            return limbs == other.limbs;
+        }
+
+        bool operator!=(const Field& other) const {
+            return limbs != other.limbs;
         }
 
         operator string() const {
-            return value.ToString(10);
+            return to_bigint().ToString(10);
         }
 
-        friend std::ostream& operator<<(std::ostream& os, const FieldElement& x) {
-            os << x.value;
+        friend std::ostream& operator<<(std::ostream& os, const Field& x) {
+            os << x.to_bigint();
             return os;
         }
+
+    private:
+        // t[k][b] is the Montgomery form of b * 2^(8k)
+        static const std::array<std::array<limbs_t, 256>, 4>& small_tables() {
+            static const auto tables = [] {
+                std::array<std::array<limbs_t, 256>, 4> t;
+                for (size_t k = 0; k != 4; k++) {
+                    for (uint64_t b = 0; b != 256; b++) {
+                        t[k][b] = montgomery::to_mont<Params>(montgomery::u64_to_limbs<Params>(b << (8 * k)));
+                    }
+                }
+                return t;
+            }();
+            return tables;
+        }
+
+        static constexpr size_t EXP_WORDS = (montgomery::WORD_BITS<Params> * Params::limbs + 63) / 64;
+
+        // Left-to-right square-and-multiply over a little-endian exponent
+        Field pow_words(const uint64_t* exp, size_t n) const {
+            Field result = from_montgomery(montgomery::constants<Params>::R_MOD_P);
+            size_t top = n;
+            while (top > 0 && exp[top - 1] == 0) top--;
+            if (top == 0) return result;
+            int bit = 63 - __builtin_clzll(exp[top - 1]);
+            for (size_t w = top; w-- > 0;) {
+                for (; bit >= 0; bit--) {
+                    result = result * result;
+                    if ((exp[w] >> bit) & 1) result = result * *this;
+                }
+                bit = 63;
+            }
+            return result;
+        }
 };
 
-FieldElement generator() {
-    BigInt g = "85408008396924667383611388730472331217";
-    FieldElement gen(g);
-    return gen;
-}
+using FieldElement = Field<P128Params>;
+using GoldilocksElement = Field<GoldilocksParams>;
+using BabyBearElement = Field<BabyBearParams>;
+
+/*
+    Sum of products with lazy reduction. The generic version reduces after every term; the
+    specializations keep the unreduced double-width products and reduce once in reduce().
+*/
+template <class F>
+class Accumulator {
+    public:
+        void add_product(const F& a, const F& b) { sum = sum + a * b; }
+        void add(const F& a) { sum = sum + a; }
+        F reduce() const { return sum; }
+
+    private:
+        F sum = F(0);
+};
+
+// Each product of Montgomery residues aR * bR is kept as a 2L-word integer; one extra word
+// counts overflows, so up to 2^WORD_BITS - 2 terms can be summed before reduce().
+template <class Params>
+class Accumulator<Field<Params> > {
+    using W = montgomery::word_t<Params>;
+    using D = montgomery::dword_t<Params>;
+    static constexpr size_t N = Params::limbs;
+    static constexpr size_t BITS = montgomery::WORD_BITS<Params>;
 
-FieldElement primitive_nth_root(BigInt n) {
-    FieldElement g = generator();
-    BigInt order = 1;
-    order <<= 119;
+    public:
+        void add_product(const Field<Params>& a, const Field<Params>& b) {
+            for (size_t i = 0; i != N; i++) {
+                W carry = 0;
+                for (size_t j = 0; j != N; j++) {
+                    D s = (D)a.limbs[i] * b.limbs[j] + t[i + j] + carry;
+                    t[i + j] = (W)s;
+                    carry = (W)(s >> BITS);
+                }
+                propagate(i + N, carry);
+            }
+        }
 
-    while (order != n) {
-        g = g^2;
-        order = order / 2;
+        // aR becomes aR * R, the same scale as a product
+        void add(const Field<Params>& a) {
+            W carry = 0;
+            for (size_t j = 0; j != N; j++) {
+                D s = (D)a.limbs[j] + t[j + N] + carry;
+                t[j + N] = (W)s;
+                carry = (W)(s >> BITS);
+            }
+            propagate(2 * N, carry);
+        }
+
+        // Montgomery reduction of the whole (2L + 1)-word sum: T R^{-1} = lo + hi R (mod p)
+        Field<Params> reduce() const {
+            W r[2 * N + 1];
+            for (size_t i = 0; i != 2 * N + 1; i++) r[i] = t[i];
+            for (size_t i = 0; i != N; i++) {
+                W m = (W)(r[i] * montgomery::constants<Params>::N_PRIME);
+                W carry = 0;
+                for (size_t j = 0; j != N; j++) {
+                    D s = (D)m * Params::modulus[j] + r[i + j] + carry;
+                    r[i + j] = (W)s;
+                    carry = (W)(s >> BITS);
+                }
+                for (size_t k = i + N; carry != 0 && k != 2 * N + 1; k++) {
+                    D s = (D)r[k] + carry;
+                    r[k] = (W)s;
+                    carry = (W)(s >> BITS);
+                }
+            }
+            typename Field<Params>::limbs_t lo, hi = {};
+            for (size_t i = 0; i != N; i++) lo[i] = r[N + i];
+            hi[0] = r[2 * N];
+            while (montgomery::geq<Params>(lo, Params::modulus)) montgomery::sub_in_place<Params>(lo, Params::modulus);
+            hi = montgomery::mul<Params>(hi, montgomery::constants<Params>::R2_MOD_P);
+            return Field<Params>::from_montgomery(montgomery::add_mod<Params>(lo, hi));
+        }
+
+    private:
+        W t[2 * N + 1] = {};
+
+        void propagate(size_t k, W carry) {
+            for (; carry != 0 && k != 2 * N + 1; k++) {
+                D s = (D)t[k] + carry;
+                t[k] = (W)s;
+                carry = (W)(s >> BITS);
+            }
+        }
+};
+
+// Montgomery's trick: inverts every element in place with a single field inversion
+// and 3(n - 1) multiplications. Zeros are left untouched.
+template <class F>
+void batch_inverse(std::span<F> xs) {
+    if (xs.empty()) return;
+    const F zero = F();
+    const F one = F(1);
+    vector<F> prefix(xs.size());
+    F acc = one;
+    for (size_t i = 0; i != xs.size(); i++) {
+        prefix[i] = acc;
+        if (xs[i] != zero) acc = acc * xs[i];
+    }
+    F acc_inv = acc.inv();
+    for (size_t i = xs.size(); i-- > 0;) {
+        if (xs[i] == zero) continue;
+        F x_inv = acc_inv * prefix[i];
+        acc_inv = acc_inv * xs[i];
+        xs[i] = x_inv;
     }
-    return g;
 }
 
-FieldElement sample(vector<uint8_t> &random_bytes) {
+template <class F>
+void batch_inverse(vector<F> &xs) {
+    batch_inverse(std::span<F>(xs));
+}
+
+// Bulk conversion of small integers, e.g. one trace row at a time
+template <class F>
+void from_u16(std::span<const uint16_t> in, std::span<F> out) {
+    assert(in.size() == out.size());
+    for (size_t i = 0; i != in.size(); i++) out[i] = F::from_small(in[i]);
+}
+
+template <class F>
+void from_u32(std::span<const uint32_t> in, std::span<F> out) {
+    assert(in.size() == out.size());
+    for (size_t i = 0; i != in.size(); i++) out[i] = F::from_small(in[i]);
+}
+
+template <class F = FieldElement>
+F generator() {
+    return F::generator();
+}
+
+template <class F = FieldElement>
+F primitive_nth_root(uint64_t n) {
+    return F::primitive_nth_root(n);
+}
+
+template <class F = FieldElement>
+F sample(vector<uint8_t> &random_bytes) {
     BigInt acc = 0;
     for (uint8_t byte : random_bytes) {
         acc = (acc << 8) ^ byte;
     }
-    return FieldElement(acc);
+    return F(acc);
 }
 
-merkle::Hash hash_from_FieldElement(const FieldElement& fe) {
-    string rep = (string)fe;
+template <class F>
+merkle::Hash hash_from_FieldElement(const F& fe) {
+    typename F::bytes_t rep = fe.to_bytes();
     merkle::Hash h;
-    SHA256(reinterpret_cast<const uint8_t*>(rep.data()), rep.size(), h.bytes);
+    SHA256(rep.data(), rep.size(), h.bytes);
     return h;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,491 @@
+#ifndef FIELDKERNELS_HPP
+#define FIELDKERNELS_HPP
+
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include "Field.hpp"
+#include "ExtField.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FIELD_KERNELS_X86 1
+#include <immintrin.h>
+#else
+#define FIELD_KERNELS_X86 0
+#endif
+
+/*
+    Element-wise field kernels over contiguous arrays:
+        add      out = a + b
+        sub      out = a - b
+        mul      out = a * b
+        scalar_mul out = a * s
+        fma      out = a * b + c
+        axpy     out = out + s * x
+
+    Vector code is compiled per function with target attributes and chosen at runtime by
+    CPU feature, so the rest of the tree needs no -mavx flags. Each vector routine handles
+    a multiple of its lane count and returns how many elements it did; the scalar loop
+    finishes the tail and is the only path on non-x86 hosts.
+
+    Limbs are de-interleaved into structure-of-arrays registers on load (one register of
+    low limbs, one of high limbs for the 128-bit field) and interleaved again on store.
+    Add/sub are vectorized for every field layout; multiplication is vectorized for 32-bit
+    Montgomery fields, where 32x32 -> 64 lane products exist. 64-bit limb products have no
+    AVX2/AVX-512F instruction and stay on the scalar __int128 path.
+*/
+namespace kernels {
+    enum class Backend { Scalar, AVX2, AVX512 };
+
+    inline Backend detect_backend() {
+#if FIELD_KERNELS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return Backend::AVX512;
+        if (__builtin_cpu_supports("avx2")) return Backend::AVX2;
+#endif
+        return Backend::Scalar;
+    }
+
+    inline Backend& active_backend() {
+        static Backend backend = detect_backend();
+        return backend;
+    }
+
+    // Forces a backend (e.g. for benchmarks); requests beyond what the CPU supports are clamped
+    inline void set_backend(Backend b) {
+        Backend best = detect_backend();
+        active_backend() = static_cast<int>(b) <= static_cast<int>(best) ? b : best;
+    }
+
+    inline const char* backend_name(Backend b) {
+        switch (b) {
+            case Backend::AVX512: return "avx512";
+            case Backend::AVX2: return "avx2";
+            default: return "scalar";
+        }
+    }
+
+    namespace detail {
+        // Whether F is a bare Montgomery element of the given word type and limb count
+        template <class F, class W, size_t L>
+        consteval bool has_layout() {
+            if constexpr (requires { typename F::params::word; typename F::limbs_t; }) {
+                return std::is_same_v<typename F::params::word, W> && F::params::limbs == L &&
+                    sizeof(F) == sizeof(typename F::limbs_t);
+            } else {
+                return false;
+            }
+        }
+
+        template <class F> constexpr bool is_u32x1 = has_layout<F, uint32_t, 1>();
+        template <class F> constexpr bool is_u64x1 = has_layout<F, uint64_t, 1>();
+        template <class F> constexpr bool is_u64x2 = has_layout<F, uint64_t, 2>();
+
+        template <class F> constexpr bool has_vector_add = is_u32x1<F> || is_u64x1<F> || is_u64x2<F>;
+        template <class F> constexpr bool has_vector_mul = is_u32x1<F>;
+
+        // Extension elements are D packed base elements, so coefficient-wise kernels run on the
+        // flattened base array
+        template <class T>
+        struct flat {
+            using type = T;
+            static constexpr size_t width = 1;
+        };
+
+        template <class B, size_t D>
+        struct flat<ExtFieldElement<B, D>> {
+            static_assert(sizeof(ExtFieldElement<B, D>) == D * sizeof(B));
+            using type = B;
+            static constexpr size_t width = D;
+        };
+
+#if FIELD_KERNELS_X86
+        // ---- AVX2 ----
+
+        __attribute__((target("avx2"))) inline __m256i cmpgt_epu64_avx2(__m256i a, __m256i b) {
+            const __m256i sign = _mm256_set1_epi64x((long long)0x8000000000000000ULL);
+            return _mm256_cmpgt_epi64(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+        }
+
+        // Single 32-bit limb: canonical inputs < p < 2^31, so min() selects the reduced value
+        __attribute__((target("avx2"))) inline __m256i add_u32_avx2(__m256i a, __m256i b, __m256i p) {
+            __m256i t = _mm256_add_epi32(a, b);
+            return _mm256_min_epu32(t, _mm256_sub_epi32(t, p));
+        }
+
+        __attribute__((target("avx2"))) inline __m256i sub_u32_avx2(__m256i a, __m256i b, __m256i p) {
+            __m256i t = _mm256_sub_epi32(a, b);
+            return _mm256_min_epu32(t, _mm256_add_epi32(t, p));
+        }
+
+        // Montgomery product of the 32-bit values held in the low half of each 64-bit lane
+        __attribute__((target("avx2"))) inline __m256i mont_u32_half_avx2(__m256i a, __m256i b, __m256i p, __m256i n_prime) {
+            __m256i prod = _mm256_mul_epu32(a, b);
+            __m256i m = _mm256_mul_epu32(prod, n_prime);
+            __m256i mp = _mm256_mul_epu32(m, p);
+            return _mm256_srli_epi64(_mm256_add_epi64(prod, mp), 32);
+        }
+
+        __attribute__((target("avx2"))) inline __m256i mul_u32_avx2(__m256i a, __m256i b, __m256i p, __m256i n_prime) {
+            __m256i even = mont_u32_half_avx2(a, b, p, n_prime);
+            __m256i odd = mont_u32_half_avx2(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32), p, n_prime);
+            __m256i t = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0b10101010);
+            return _mm256_min_epu32(t, _mm256_sub_epi32(t, p));
+        }
+
+        // Single 64-bit limb
+        __attribute__((target("avx2"))) inline __m256i add_u64_avx2(__m256i a, __m256i b, __m256i p) {
+            __m256i t = _mm256_add_epi64(a, b);
+            __m256i carry = cmpgt_epu64_avx2(a, t);
+            __m256i below_p = cmpgt_epu64_avx2(p, t);
+            __m256i reduce = _mm256_or_si256(carry, _mm256_xor_si256(below_p, _mm256_set1_epi64x(-1)));
+            return _mm256_sub_epi64(t, _mm256_and_si256(reduce, p));
+        }
+
+        __attribute__((target("avx2"))) inline __m256i sub_u64_avx2(__m256i a, __m256i b, __m256i p) {
+            __m256i t = _mm256_sub_epi64(a, b);
+            __m256i borrow = cmpgt_epu64_avx2(b, a);
+            return _mm256_add_epi64(t, _mm256_and_si256(borrow, p));
+        }
+
+        // Two 64-bit limbs, four elements held as SoA registers (lo, hi)
+        __attribute__((target("avx2"))) inline void add_u64x2_avx2(__m256i& lo, __m256i& hi, __m256i blo, __m256i bhi, __m256i plo, __m256i phi) {
+            const __m256i ones = _mm256_set1_epi64x(-1);
+            __m256i slo = _mm256_add_epi64(lo, blo);
+            __m256i c = cmpgt_epu64_avx2(lo, slo); // all-ones on carry
+            __m256i shi = _mm256_sub_epi64(_mm256_add_epi64(hi, bhi), c);
+            // p < 2^128 and inputs < p, so the sum overflows 128 bits only if it also exceeds p
+            __m256i overflow = _mm256_or_si256(cmpgt_epu64_avx2(hi, shi), _mm256_and_si256(_mm256_cmpeq_epi64(hi, shi), c));
+            __m256i geq_hi = cmpgt_epu64_avx2(shi, phi);
+            __m256i eq_hi = _mm256_cmpeq_epi64(shi, phi);
+            __m256i geq_lo = _mm256_xor_si256(cmpgt_epu64_avx2(plo, slo), ones);
+            __m256i reduce = _mm256_or_si256(overflow, _mm256_or_si256(geq_hi, _mm256_and_si256(eq_hi, geq_lo)));
+            __m256i rlo = _mm256_and_si256(reduce, plo);
+            __m256i rhi = _mm256_and_si256(reduce, phi);
+            __m256i borrow = cmpgt_epu64_avx2(rlo, slo);
+            lo = _mm256_sub_epi64(slo, rlo);
+            hi = _mm256_add_epi64(_mm256_sub_epi64(shi, rhi), borrow);
+        }
+
+        __attribute__((target("avx2"))) inline void sub_u64x2_avx2(__m256i& lo, __m256i& hi, __m256i blo, __m256i bhi, __m256i plo, __m256i phi) {
+            __m256i borrow_lo = cmpgt_epu64_avx2(blo, lo);
+            __m256i dlo = _mm256_sub_epi64(lo, blo);
+            __m256i dhi = _mm256_add_epi64(_mm256_sub_epi64(hi, bhi), borrow_lo);
+            __m256i negative = _mm256_or_si256(cmpgt_epu64_avx2(bhi, hi), _mm256_and_si256(_mm256_cmpeq_epi64(bhi, hi), borrow_lo));
+            __m256i alo = _mm256_and_si256(negative, plo);
+            __m256i ahi = _mm256_and_si256(negative, phi);
+            __m256i rlo = _mm256_add_epi64(dlo, alo);
+            __m256i carry = cmpgt_epu64_avx2(dlo, rlo);
+            lo = rlo;
+            hi = _mm256_sub_epi64(_mm256_add_epi64(dhi, ahi), carry);
+        }
+
+        template <class F, bool Sub>
+        __attribute__((target("avx2"))) size_t add_sub_avx2(F* out, const F* a, const F* b, size_t n) {
+            using P = typename F::params;
+            size_t i = 0;
+            if constexpr (is_u32x1<F>) {
+                const __m256i p = _mm256_set1_epi32((int)P::modulus[0]);
+                for (; i + 8 <= n; i += 8) {
+                    __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+                    __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+                    __m256i r = Sub ? sub_u32_avx2(va, vb, p) : add_u32_avx2(va, vb, p);
+                    _mm256_storeu_si256((__m256i*)(out + i), r);
+                }
+            } else if constexpr (is_u64x1<F>) {
+                const __m256i p = _mm256_set1_epi64x((long long)P::modulus[0]);
+                for (; i + 4 <= n; i += 4) {
+                    __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+                    __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+                    __m256i r = Sub ? sub_u64_avx2(va, vb, p) : add_u64_avx2(va, vb, p);
+                    _mm256_storeu_si256((__m256i*)(out + i), r);
+                }
+            } else if constexpr (is_u64x2<F>) {
+                const __m256i plo = _mm256_set1_epi64x((long long)P::modulus[0]);
+                const __m256i phi = _mm256_set1_epi64x((long long)P::modulus[1]);
+                for (; i + 4 <= n; i += 4) {
+                    __m256i a0 = _mm256_loadu_si256((const __m256i*)(a + i));
+                    __m256i a1 = _mm256_loadu_si256((const __m256i*)(a + i + 2));
+                    __m256i b0 = _mm256_loadu_si256((const __m256i*)(b + i));
+                    __m256i b1 = _mm256_loadu_si256((const __m256i*)(b + i + 2));
+                    __m256i lo = _mm256_unpacklo_epi64(a0, a1), hi = _mm256_unpackhi_epi64(a0, a1);
+                    __m256i blo = _mm256_unpacklo_epi64(b0, b1), bhi = _mm256_unpackhi_epi64(b0, b1);
+                    if (Sub) sub_u64x2_avx2(lo, hi, blo, bhi, plo, phi);
+                    else add_u64x2_avx2(lo, hi, blo, bhi, plo, phi);
+                    _mm256_storeu_si256((__m256i*)(out + i), _mm256_unpacklo_epi64(lo, hi));
+                    _mm256_storeu_si256((__m256i*)(out + i + 2), _mm256_unpackhi_epi64(lo, hi));
+                }
+            }
+            return i;
+        }
+
+        // out = a * b (+ c when c != nullptr); b_stride 0 broadcasts b[0]
+        template <class F>
+        __attribute__((target("avx2"))) size_t mul_avx2(F* out, const F* a, const F* b, size_t b_stride, const F* c, size_t n) {
+            using P = typename F::params;
+            size_t i = 0;
+            if constexpr (is_u32x1<F>) {
+                const __m256i p = _mm256_set1_epi32((int)P::modulus[0]);
+                const __m256i n_prime = _mm256_set1_epi32((int)montgomery::constants<P>::N_PRIME);
+                const __m256i bcast = _mm256_set1_epi32((int)b[0].limbs[0]);
+                for (; i + 8 <= n; i += 8) {
+                    __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+                    __m256i vb = b_stride ? _mm256_loadu_si256((const __m256i*)(b + i)) : bcast;
+                    __m256i r = mul_u32_avx2(va, vb, p, n_prime);
+                    if (c) r = add_u32_avx2(r, _mm256_loadu_si256((const __m256i*)(c + i)), p);
+                    _mm256_storeu_si256((__m256i*)(out + i), r);
+                }
+            }
+            return i;
+        }
+
+        // ---- AVX-512 ----
+
+        __attribute__((target("avx512f"))) inline __m512i add_u32_avx512(__m512i a, __m512i b, __m512i p) {
+            __m512i t = _mm512_add_epi32(a, b);
+            return _mm512_min_epu32(t, _mm512_sub_epi32(t, p));
+        }
+
+        __attribute__((target("avx512f"))) inline __m512i sub_u32_avx512(__m512i a, __m512i b, __m512i p) {
+            __m512i t = _mm512_sub_epi32(a, b);
+            return _mm512_min_epu32(t, _mm512_add_epi32(t, p));
+        }
+
+        __attribute__((target("avx512f"))) inline __m512i mont_u32_half_avx512(__m512i a, __m512i b, __m512i p, __m512i n_prime) {
+            __m512i prod = _mm512_mul_epu32(a, b);
+            __m512i m = _mm512_mul_epu32(prod, n_prime);
+            __m512i mp = _mm512_mul_epu32(m, p);
+            return _mm512_srli_epi64(_mm512_add_epi64(prod, mp), 32);
+        }
+
+        __attribute__((target("avx512f"))) inline __m512i mul_u32_avx512(__m512i a, __m512i b, __m512i p, __m512i n_prime) {
+            __m512i even = mont_u32_half_avx512(a, b, p, n_prime);
+            __m512i odd = mont_u32_half_avx512(_mm512_srli_epi64(a, 32), _mm512_srli_epi64(b, 32), p, n_prime);
+            __m512i t = _mm512_mask_blend_epi32(0xAAAA, even, _mm512_slli_epi64(odd, 32));
+            return _mm512_min_epu32(t, _mm512_sub_epi32(t, p));
+        }
+
+        __attribute__((target("avx512f"))) inline __m512i add_u64_avx512(__m512i a, __m512i b, __m512i p) {
+            __m512i t = _mm512_add_epi64(a, b);
+            __mmask8 reduce = _mm512_cmplt_epu64_mask(t, a) | _mm512_cmpge_epu64_mask(t, p);
+            return _mm512_mask_sub_epi64(t, reduce, t, p);
+        }
+
+        __attribute__((target("avx512f"))) inline __m512i sub_u64_avx512(__m512i a, __m512i b, __m512i p) {
+            __m512i t = _mm512_sub_epi64(a, b);
+            return _mm512_mask_add_epi64(t, _mm512_cmplt_epu64_mask(a, b), t, p);
+        }
+
+        __attribute__((target("avx512f"))) inline void add_u64x2_avx512(__m512i& lo, __m512i& hi, __m512i blo, __m512i bhi, __m512i plo, __m512i phi) {
+            __m512i slo = _mm512_add_epi64(lo, blo);
+            __mmask8 c = _mm512_cmplt_epu64_mask(slo, lo);
+            __m512i shi = _mm512_mask_add_epi64(_mm512_add_epi64(hi, bhi), c, _mm512_add_epi64(hi, bhi), _mm512_set1_epi64(1));
+            __mmask8 overflow = _mm512_cmplt_epu64_mask(shi, hi) | (_mm512_cmpeq_epu64_mask(shi, hi) & c);
+            __mmask8 reduce = overflow | _mm512_cmpgt_epu64_mask(shi, phi) |
+                (_mm512_cmpeq_epu64_mask(shi, phi) & _mm512_cmpge_epu64_mask(slo, plo));
+            __mmask8 borrow = reduce & _mm512_cmplt_epu64_mask(slo, plo);
+            lo = _mm512_mask_sub_epi64(slo, reduce, slo, plo);
+            hi = _mm512_mask_sub_epi64(shi, reduce, shi, phi);
+            hi = _mm512_mask_sub_epi64(hi, borrow, hi, _mm512_set1_epi64(1));
+        }
+
+        __attribute__((target("avx512f"))) inline void sub_u64x2_avx512(__m512i& lo, __m512i& hi, __m512i blo, __m512i bhi, __m512i plo, __m512i phi) {
+            __mmask8 borrow_lo = _mm512_cmplt_epu64_mask(lo, blo);
+            __mmask8 negative = _mm512_cmplt_epu64_mask(hi, bhi) | (_mm512_cmpeq_epu64_mask(hi, bhi) & borrow_lo);
+            __m512i dlo = _mm512_sub_epi64(lo, blo);
+            __m512i dhi = _mm512_sub_epi64(hi, bhi);
+            dhi = _mm512_mask_sub_epi64(dhi, borrow_lo, dhi, _mm512_set1_epi64(1));
+            __m512i rlo = _mm512_mask_add_epi64(dlo, negative, dlo, plo);
+            __mmask8 carry = negative & _mm512_cmplt_epu64_mask(rlo, dlo);
+            __m512i rhi = _mm512_mask_add_epi64(dhi, negative, dhi, phi);
+            lo = rlo;
+            hi = _mm512_mask_add_epi64(rhi, carry, rhi, _mm512_set1_epi64(1));
+        }
+
+        template <class F, bool Sub>
+        __attribute__((target("avx512f"))) size_t add_sub_avx512(F* out, const F* a, const F* b, size_t n) {
+            using P = typename F::params;
+            size_t i = 0;
+            if constexpr (is_u32x1<F>) {
+                const __m512i p = _mm512_set1_epi32((int)P::modulus[0]);
+                for (; i + 16 <= n; i += 16) {
+                    __m512i va = _mm512_loadu_si512((const void*)(a + i));
+                    __m512i vb = _mm512_loadu_si512((const void*)(b + i));
+                    __m512i r = Sub ? sub_u32_avx512(va, vb, p) : add_u32_avx512(va, vb, p);
+                    _mm512_storeu_si512((void*)(out + i), r);
+                }
+            } else if constexpr (is_u64x1<F>) {
+                const __m512i p = _mm512_set1_epi64((long long)P::modulus[0]);
+                for (; i + 8 <= n; i += 8) {
+                    __m512i va = _mm512_loadu_si512((const void*)(a + i));
+                    __m512i vb = _mm512_loadu_si512((const void*)(b + i));
+                    __m512i r = Sub ? sub_u64_avx512(va, vb, p) : add_u64_avx512(va, vb, p);
+                    _mm512_storeu_si512((void*)(out + i), r);
+                }
+            } else if constexpr (is_u64x2<F>) {
+                const __m512i plo = _mm512_set1_epi64((long long)P::modulus[0]);
+                const __m512i phi = _mm512_set1_epi64((long long)P::modulus[1]);
+                for (; i + 8 <= n; i += 8) {
+                    __m512i a0 = _mm512_loadu_si512((const void*)(a + i));
+                    __m512i a1 = _mm512_loadu_si512((const void*)(a + i + 4));
+                    __m512i b0 = _mm512_loadu_si512((const void*)(b + i));
+                    __m512i b1 = _mm512_loadu_si512((const void*)(b + i + 4));
+                    __m512i lo = _mm512_unpacklo_epi64(a0, a1), hi = _mm512_unpackhi_epi64(a0, a1);
+                    __m512i blo = _mm512_unpacklo_epi64(b0, b1), bhi = _mm512_unpackhi_epi64(b0, b1);
+                    if (Sub) sub_u64x2_avx512(lo, hi, blo, bhi, plo, phi);
+                    else add_u64x2_avx512(lo, hi, blo, bhi, plo, phi);
+                    _mm512_storeu_si512((void*)(out + i), _mm512_unpacklo_epi64(lo, hi));
+                    _mm512_storeu_si512((void*)(out + i + 4), _mm512_unpackhi_epi64(lo, hi));
+                }
+            }
+            return i;
+        }
+
+        template <class F>
+        __attribute__((target("avx512f"))) size_t mul_avx512(F* out, const F* a, const F* b, size_t b_stride, const F* c, size_t n) {
+            using P = typename F::params;
+            size_t i = 0;
+            if constexpr (is_u32x1<F>) {
+                const __m512i p = _mm512_set1_epi32((int)P::modulus[0]);
+                const __m512i n_prime = _mm512_set1_epi32((int)montgomery::constants<P>::N_PRIME);
+                const __m512i bcast = _mm512_set1_epi32((int)b[0].limbs[0]);
+                for (; i + 16 <= n; i += 16) {
+                    __m512i va = _mm512_loadu_si512((const void*)(a + i));
+                    __m512i vb = b_stride ? _mm512_loadu_si512((const void*)(b + i)) : bcast;
+                    __m512i r = mul_u32_avx512(va, vb, p, n_prime);
+                    if (c) r = add_u32_avx512(r, _mm512_loadu_si512((const void*)(c + i)), p);
+                    _mm512_storeu_si512((void*)(out + i), r);
+                }
+            }
+            return i;
+        }
+#endif
+
+        template <class F, bool Sub>
+        size_t add_sub_vector(F* out, const F* a, const F* b, size_t n) {
+#if FIELD_KERNELS_X86
+            if constexpr (has_vector_add<F>) {
+                switch (active_backend()) {
+                    case Backend::AVX512: return add_sub_avx512<F, Sub>(out, a, b, n);
+                    case Backend::AVX2: return add_sub_avx2<F, Sub>(out, a, b, n);
+                    default: break;
+                }
+            }
+#endif
+            return 0;
+        }
+
+        template <class F>
+        size_t mul_vector(F* out, const F* a, const F* b, size_t b_stride, const F* c, size_t n) {
+#if FIELD_KERNELS_X86
+            if constexpr (has_vector_mul<F>) {
+                switch (active_backend()) {
+                    case Backend::AVX512: return mul_avx512<F>(out, a, b, b_stride, c, n);
+                    case Backend::AVX2: return mul_avx2<F>(out, a, b, b_stride, c, n);
+                    default: break;
+                }
+            }
+#endif
+            return 0;
+        }
+    }
+
+    template <class T>
+    void add(std::span<T> out, std::span<const T> a, std::span<const T> b) {
+        assert(a.size() == out.size() && b.size() == out.size());
+        using B = typename detail::flat<T>::type;
+        constexpr size_t W = detail::flat<T>::width;
+        B* o = reinterpret_cast<B*>(out.data());
+        const B* x = reinterpret_cast<const B*>(a.data());
+        const B* y = reinterpret_cast<const B*>(b.data());
+        size_t n = out.size() * W;
+        size_t i = detail::add_sub_vector<B, false>(o, x, y, n);
+        for (; i != n; i++) o[i] = x[i] + y[i];
+    }
+
+    template <class T>
+    void sub(std::span<T> out, std::span<const T> a, std::span<const T> b) {
+        assert(a.size() == out.size() && b.size() == out.size());
+        using B = typename detail::flat<T>::type;
+        constexpr size_t W = detail::flat<T>::width;
+        B* o = reinterpret_cast<B*>(out.data());
+        const B* x = reinterpret_cast<const B*>(a.data());
+        const B* y = reinterpret_cast<const B*>(b.data());
+        size_t n = out.size() * W;
+        size_t i = detail::add_sub_vector<B, true>(o, x, y, n);
+        for (; i != n; i++) o[i] = x[i] - y[i];
+    }
+
+    // out = a * b; b may be over the base field of a
+    template <class T, class S>
+    void mul(std::span<T> out, std::span<const T> a, std::span<const S> b) {
+        assert(a.size() == out.size() && b.size() == out.size());
+        size_t i = 0;
+        if constexpr (std::is_same_v<T, S>) {
+            i = detail::mul_vector<T>(out.data(), a.data(), b.data(), 1, nullptr, out.size());
+        }
+        for (; i != out.size(); i++) out[i] = a[i] * b[i];
+    }
+
+    // out = a * s; s may be over the base field of a, in which case the extension is flattened
+    template <class T, class S>
+    void scalar_mul(std::span<T> out, std::span<const T> a, const S &s) {
+        assert(a.size() == out.size());
+        if constexpr (std::is_same_v<S, typename detail::flat<T>::type>) {
+            constexpr size_t W = detail::flat<T>::width;
+            S* o = reinterpret_cast<S*>(out.data());
+            const S* x = reinterpret_cast<const S*>(a.data());
+            size_t n = out.size() * W;
+            size_t i = detail::mul_vector<S>(o, x, &s, 0, nullptr, n);
+            for (; i != n; i++) o[i] = x[i] * s;
+        } else {
+            for (size_t i = 0; i != out.size(); i++) out[i] = a[i] * s;
+        }
+    }
+
+    // out = a * b + c
+    template <class F>
+    void fma(std::span<F> out, std::span<const F> a, std::span<const F> b, std::span<const F> c) {
+        assert(a.size() == out.size() && b.size() == out.size() && c.size() == out.size());
+        size_t i = detail::mul_vector<F>(out.data(), a.data(), b.data(), 1, c.data(), out.size());
+        for (; i != out.size(); i++) out[i] = a[i] * b[i] + c[i];
+    }
+
+    // out += s * x; s and out may live in an extension of x's field, which takes the scalar path
+    template <class E, class F>
+    void axpy(std::span<E> out, const E &s, std::span<const F> x) {
+        assert(x.size() == out.size());
+        size_t i = 0;
+        if constexpr (std::is_same_v<E, F>) {
+            i = detail::mul_vector<F>(out.data(), x.data(), &s, 0, out.data(), out.size());
+        }
+        for (; i != out.size(); i++) out[i] = out[i] + s * x[i];
+    }
+
+    // out[j] = sum_i coeffs[i] * columns[i][j], each output reduced once
+    template <class E, class F>
+    void linear_combination(vector<E> &out, const vector<E> &coeffs, const vector<vector<F> > &columns) {
+        assert(coeffs.size() == columns.size());
+        for (size_t j = 0; j != out.size(); j++) {
+            Accumulator<E> acc;
+            for (size_t i = 0; i != columns.size(); i++) acc.add_product(coeffs[i], columns[i][j]);
+            out[j] = acc.reduce();
+        }
+    }
+
+    // Vector overloads, since spans are not deduced through conversions
+    template <class T>
+    void add(vector<T> &out, const vector<T> &a, const vector<T> &b) { add<T>(std::span<T>(out), a, b); }
+    template <class T>
+    void sub(vector<T> &out, const vector<T> &a, const vector<T> &b) { sub<T>(std::span<T>(out), a, b); }
+    template <class T, class S>
+    void mul(vector<T> &out, const vector<T> &a, const vector<S> &b) { mul<T, S>(std::span<T>(out), a, b); }
+    template <class T, class S>
+    void scalar_mul(vector<T> &out, const vector<T> &a, const S &s) { scalar_mul<T, S>(std::span<T>(out), a, s); }
+    template <class F>
+    void fma(vector<F> &out, const vector<F> &a, const vector<F> &b, const vector<F> &c) { fma<F>(std::span<F>(out), a, b, c); }
+    template <class E, class F>
+    void axpy(vector<E> &out, const E &s, const vector<F> &x) { axpy<E, F>(std::span<E>(out), s, x); }
+}
+
+#endif
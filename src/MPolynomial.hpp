@@ -21,9 +21,10 @@ vector<T> pad_vector(const vector<T>& vec, size_t size, T value = T()) {
     return new_vec;
 }
 
-class MPolynomial {
+template <typename F>
+class BasicMPolynomial {
     public:
-    map<vector<BigInt>, FieldElement> dict;
+    map<vector<BigInt>, F> dict;
     /*
     f(x, y, z) = 17 + 2xy + 42z - 19x^6 * y^3 * z^12 would be represented as:
     {
@@ -34,25 +35,25 @@ class MPolynomial {
     }
     */
 
-    MPolynomial() {}
-    MPolynomial(const map<vector<BigInt>, FieldElement>& dict) : dict(dict) {}
-    MPolynomial(const FieldElement& c) {
+    BasicMPolynomial() {}
+    BasicMPolynomial(const map<vector<BigInt>, F>& dict) : dict(dict) {}
+    BasicMPolynomial(const F& c) {
         vector<BigInt> exp(1, (BigInt)0);
         dict[exp] = c;
     }
-    MPolynomial(const Polynomial& poly, const size_t& index) {
+    BasicMPolynomial(const BasicPolynomial<F>& poly, const size_t& index) {
         if (poly.degree() == -1) return;
-        map<vector<BigInt>, FieldElement> res_dict;
+        map<vector<BigInt>, F> res_dict;
         for (size_t i = 0; i != poly.coeffs.size(); i++) {
             vector<BigInt> exp(index + 1, (BigInt)0);
-            exp[index] = static_cast<ttmath::ulint>(i);
+            exp[index] = static_cast<ttmath::uint>(i);
             res_dict[exp] = poly.coeffs[i];
         }
         this->dict = res_dict;
     }
 
-    MPolynomial operator+(const MPolynomial &other) const {
-        map<vector<BigInt>, FieldElement> res_dict;
+    BasicMPolynomial operator+(const BasicMPolynomial &other) const {
+        map<vector<BigInt>, F> res_dict;
         vector<size_t> variable_count;
         for (const auto& pair : dict) {
             variable_count.push_back(pair.first.size());
@@ -77,11 +78,11 @@ class MPolynomial {
                 res_dict[padded_key] = pair.second;
             }
         }
-        return MPolynomial(res_dict);
+        return BasicMPolynomial(res_dict);
     }
 
-    MPolynomial operator*(const MPolynomial &other) const {
-        map<vector<BigInt>, FieldElement> res_dict;
+    BasicMPolynomial operator*(const BasicMPolynomial &other) const {
+        map<vector<BigInt>, F> res_dict;
         vector<size_t> variable_count;
         for (const auto& pair : dict) {
             variable_count.push_back(pair.first.size());
@@ -107,29 +108,29 @@ class MPolynomial {
                 }
             }
         }
-        return MPolynomial(res_dict);
+        return BasicMPolynomial(res_dict);
     }
 
-    MPolynomial operator-() const {
-        map<vector<BigInt>, FieldElement> neg_dict;
+    BasicMPolynomial operator-() const {
+        map<vector<BigInt>, F> neg_dict;
         for (const auto& pair : dict) {
             neg_dict[pair.first] = -pair.second;
         }
-        return MPolynomial(neg_dict);
+        return BasicMPolynomial(neg_dict);
     }
 
-    MPolynomial operator-(const MPolynomial &other) const {
+    BasicMPolynomial operator-(const BasicMPolynomial &other) const {
         return this->operator+(-other);
     }
 
-    MPolynomial operator^(const BigInt &exponent) const {
-        if (this->dict.empty()) return MPolynomial();
+    BasicMPolynomial operator^(const BigInt &exponent) const {
+        if (this->dict.empty()) return BasicMPolynomial();
         size_t num_vars = this->dict.begin()->first.size();
         vector<BigInt> exp(num_vars, (BigInt)0);
-        map<vector<BigInt>, FieldElement> res_dict;
-        res_dict[exp] = FieldElement(1);
-        MPolynomial res = MPolynomial(res_dict);
-        MPolynomial base = *this;
+        map<vector<BigInt>, F> res_dict;
+        res_dict[exp] = F(1);
+        BasicMPolynomial res = BasicMPolynomial(res_dict);
+        BasicMPolynomial base = *this;
         BigInt exp_copy = exponent;
         while (exp_copy != 0 && !base.is_zero()) {
             if (exp_copy % 2 == 1) res = res * base;
@@ -139,25 +140,51 @@ class MPolynomial {
         return res;
     }
 
-    FieldElement operator[](const vector<FieldElement>& x) const {
-        FieldElement result = FieldElement(0);
+    F operator[](const vector<F>& x) const {
+        Accumulator<F> result;
         for (const auto& pair : dict) {
-            FieldElement prod = pair.second;
+            F monomial = F(1);
             for (size_t i = 0; i != pair.first.size(); i++) {
-                prod = prod * (x[i]^(pair.first[i]));
+                monomial = monomial * (x[i]^(pair.first[i]));
             }
-            result = result + prod;
+            result.add_product(pair.second, monomial);
         }
-        return result;
+        return result.reduce();
     }
 
-    Polynomial evaluate_symbolic(const vector<Polynomial>& x) const {
-        Polynomial result;
+    // Pointwise evaluation over codewords: result[j] = f(x[0][j], x[1][j], ...), with every
+    // monomial built from whole-codeword products
+    vector<F> evaluate_codewords(const vector<vector<F> >& x) const {
+        const size_t n = x.empty() ? 0 : x[0].size();
+        vector<Accumulator<F> > result(n);
+        vector<F> monomial(n), power(n);
         for (const auto& pair : dict) {
-            Polynomial prod = Polynomial(vector<FieldElement>{pair.second});
+            std::fill(monomial.begin(), monomial.end(), F(1));
+            for (size_t i = 0; i != pair.first.size(); i++) {
+                if (pair.first[i] == 0) continue;
+                power = x[i];
+                BigInt exp = pair.first[i];
+                while (true) {
+                    if (exp % 2 == 1) kernels::mul(monomial, monomial, power);
+                    exp = exp >> 1;
+                    if (exp == 0) break;
+                    kernels::mul(power, power, power);
+                }
+            }
+            for (size_t j = 0; j != n; j++) result[j].add_product(pair.second, monomial[j]);
+        }
+        vector<F> values(n);
+        for (size_t j = 0; j != n; j++) values[j] = result[j].reduce();
+        return values;
+    }
+
+    BasicPolynomial<F> evaluate_symbolic(const vector<BasicPolynomial<F> >& x) const {
+        vector<Accumulator<F> > result;
+        for (const auto& pair : dict) {
+            BasicPolynomial<F> prod = BasicPolynomial<F>(vector<F>{F(1)});
             for (size_t i = 0; i != pair.first.size(); i++) {
                 try {
-                    prod = prod * (x[i]^(pair.first[i]));
+                    prod *= x[i]^(pair.first[i]);
                 }
                 catch (const std::exception& e) {
                     std::cerr << "Error: " << e.what() << std::endl;
@@ -187,14 +214,17 @@ class MPolynomial {
                     assert(false);
                 };
             }
-            result = result + prod;
+            if (result.size() < prod.coeffs.size()) result.resize(prod.coeffs.size());
+            for (size_t k = 0; k != prod.coeffs.size(); k++) result[k].add_product(pair.second, prod.coeffs[k]);
         }
-        return result;
+        vector<F> coeffs(result.size());
+        for (size_t k = 0; k != result.size(); k++) coeffs[k] = result[k].reduce();
+        return BasicPolynomial<F>(coeffs);
     }
     bool is_zero() const {
         if (this->dict.empty()) return true;
         for (const auto& pair: dict) {
-            if (pair.second != FieldElement(0)) {
+            if (pair.second != F(0)) {
                 return false;
             }
         }
@@ -202,14 +232,17 @@ class MPolynomial {
     }
 };
 
-vector<MPolynomial> identity(const size_t &num_vars) {
-    vector<MPolynomial> result;
+using MPolynomial = BasicMPolynomial<FieldElement>;
+
+template <class F = FieldElement>
+vector<BasicMPolynomial<F> > identity(const size_t &num_vars) {
+    vector<BasicMPolynomial<F> > result;
     for (size_t i = 0; i != num_vars; i++) {
         vector<BigInt> exp(num_vars, (BigInt)0);
         exp[i] = 1;
-        map<vector<BigInt>, FieldElement> dict;
-        dict[exp] = FieldElement(1);
-        MPolynomial poly(dict);
+        map<vector<BigInt>, F> dict;
+        dict[exp] = F(1);
+        BasicMPolynomial<F> poly(dict);
         result.push_back(poly);
     }
     return result;
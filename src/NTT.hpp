@@ -0,0 +1,390 @@
+#ifndef NTT_HPP
+#define NTT_HPP
+
+#include <span>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include "Field.hpp"
+#include "Domain.hpp"
+#include "ExtField.hpp"
+#include "Parallel.hpp"
+
+/*
+    Number theoretic transform over the subgroup of order n = 2^k generated by
+    primitive_nth_root(n). forward() takes coefficients to evaluations at omega^0 .. omega^{n-1}
+    and inverse() takes them back; both work in place and in natural order. The butterflies run
+    two radix-2 stages per pass over memory (radix 4) from twiddle tables cached per size, so
+    repeated transforms of one size share them.
+
+    T is the coefficient type and F the field of the twiddles, so extension-field vectors can be
+    transformed over the base subgroup.
+*/
+namespace NTT {
+    // Field the twiddles are taken from: the field itself, or the base of an extension
+    template <class T>
+    struct twiddle_field {
+        using type = T;
+    };
+
+    template <class B, size_t D>
+    struct twiddle_field<ExtFieldElement<B, D> > {
+        using type = B;
+    };
+
+    template <class T>
+    using twiddle_field_t = typename twiddle_field<T>::type;
+
+    // Largest transform the field supports
+    template <class T>
+    constexpr size_t max_size() {
+        constexpr size_t k = twiddle_field_t<T>::params::two_adicity;
+        return k >= 63 ? (size_t)1 << 63 : (size_t)1 << k;
+    }
+
+    inline size_t log2_exact(size_t n) {
+        assert(n != 0 && (n & (n - 1)) == 0);
+        return __builtin_ctzll(n);
+    }
+
+    template <class T>
+    void bit_reverse(std::span<T> a) {
+        const size_t n = a.size();
+        assert((n & (n - 1)) == 0);
+        if (n <= 2) return;
+        for (size_t i = 1, j = 0; i != n; i++) {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) std::swap(a[i], a[j]);
+        }
+    }
+
+    /*
+        Twiddles of a length-n transform, laid out pass by pass in the order the kernels read
+        them. A radix-4 pass fuses the radix-2 stages of block length 2h and 4h into one sweep over
+        memory; its butterfly j < h reads (w_2h^j, w_4h^j, w_4h^(j+h)) from three consecutive
+        slots, w_L being an element of order L. When log2 n is odd a last radix-2 pass over blocks
+        of n reads w_n^j. Cached per size like Domain.
+    */
+    template <class F>
+    class Twiddles {
+        public:
+            struct Pass {
+                size_t half, offset;
+                bool radix4;
+            };
+
+            // Smallest blocks first, the order decimation in time runs them
+            vector<Pass> passes;
+            vector<F> forward, inverse;
+
+            static std::shared_ptr<const Twiddles> get(size_t n) {
+                static std::mutex lock;
+                static std::map<size_t, std::shared_ptr<const Twiddles> > cache;
+                std::lock_guard<std::mutex> guard(lock);
+                auto &slot = cache[n];
+                if (!slot) slot = std::shared_ptr<const Twiddles>(new Twiddles(n));
+                return slot;
+            }
+
+        private:
+            explicit Twiddles(size_t n) {
+                auto domain = Domain<F>::subgroup(n);
+                const vector<F> &roots = domain->elements(), &inverse_roots = domain->inverses();
+                size_t h = 1;
+                for (; 4 * h <= n; h *= 4) {
+                    passes.push_back({h, forward.size(), true});
+                    for (size_t j = 0; j != h; j++) {
+                        for (size_t k : {j * (n / (2 * h)), j * (n / (4 * h)), (j + h) * (n / (4 * h))}) {
+                            forward.push_back(roots[k]);
+                            inverse.push_back(inverse_roots[k]);
+                        }
+                    }
+                }
+                if (2 * h == n) {
+                    passes.push_back({h, forward.size(), false});
+                    forward.insert(forward.end(), roots.begin(), roots.begin() + h);
+                    inverse.insert(inverse.end(), inverse_roots.begin(), inverse_roots.begin() + h);
+                }
+            }
+    };
+
+    // Transforms at least this long split each pass across threads
+    inline size_t PARALLEL_THRESHOLD = (size_t)1 << 14;
+    // Fewest butterflies handed to one thread
+    inline size_t PARALLEL_GRAIN = (size_t)1 << 11;
+
+    // fn(start, j) for every butterfly of a pass over blocks of radix * half. With threaded set
+    // the butterflies are partitioned across the pool; each computes the same values whichever
+    // thread runs it.
+    template <class Fn>
+    void for_butterflies(size_t n, size_t half, size_t radix, bool threaded, Fn &&fn) {
+        const size_t block = radix * half;
+        if (!threaded) {
+            for (size_t start = 0; start != n; start += block) {
+                for (size_t j = 0; j != half; j++) fn(start, j);
+            }
+            return;
+        }
+        parallel::for_range(n / radix, PARALLEL_GRAIN, [&](size_t begin, size_t end) {
+            size_t start = (begin / half) * block, j = begin % half;
+            for (size_t b = begin; b != end; b++) {
+                fn(start, j);
+                if (++j == half) {
+                    j = 0;
+                    start += block;
+                }
+            }
+        });
+    }
+
+    // Decimation in time (Cooley-Tukey): bit-reversed input to natural-order output
+    template <class T, class F>
+    void dit(std::span<T> a, const vector<typename Twiddles<F>::Pass> &passes, const vector<F> &table, bool threaded) {
+        T *x = a.data();
+        for (const auto &pass : passes) {
+            const size_t h = pass.half;
+            const F *w = table.data() + pass.offset;
+            if (!pass.radix4) {
+                for_butterflies(a.size(), h, 2, threaded, [=](size_t start, size_t j) {
+                    T *p = x + start + j;
+                    const T u = p[0], v = p[h] * w[j];
+                    p[0] = u + v;
+                    p[h] = u - v;
+                });
+                continue;
+            }
+            for_butterflies(a.size(), h, 4, threaded, [=](size_t start, size_t j) {
+                T *p = x + start + j;
+                const F *t = w + 3 * j;
+                const T v1 = p[h] * t[0], v3 = p[3 * h] * t[0];
+                const T b0 = p[0] + v1, b1 = p[0] - v1;
+                const T c2 = (p[2 * h] + v3) * t[1], c3 = (p[2 * h] - v3) * t[2];
+                p[0] = b0 + c2;
+                p[2 * h] = b0 - c2;
+                p[h] = b1 + c3;
+                p[3 * h] = b1 - c3;
+            });
+        }
+    }
+
+    // Decimation in frequency (Gentleman-Sande), the passes of dit() in reverse: natural-order
+    // input to bit-reversed output
+    template <class T, class F>
+    void dif(std::span<T> a, const vector<typename Twiddles<F>::Pass> &passes, const vector<F> &table, bool threaded) {
+        T *x = a.data();
+        for (auto it = passes.rbegin(); it != passes.rend(); ++it) {
+            const size_t h = it->half;
+            const F *w = table.data() + it->offset;
+            if (!it->radix4) {
+                for_butterflies(a.size(), h, 2, threaded, [=](size_t start, size_t j) {
+                    T *p = x + start + j;
+                    const T u = p[0], v = p[h];
+                    p[0] = u + v;
+                    p[h] = (u - v) * w[j];
+                });
+                continue;
+            }
+            for_butterflies(a.size(), h, 4, threaded, [=](size_t start, size_t j) {
+                T *p = x + start + j;
+                const F *t = w + 3 * j;
+                const T b0 = p[0] + p[2 * h], b2 = (p[0] - p[2 * h]) * t[1];
+                const T b1 = p[h] + p[3 * h], b3 = (p[h] - p[3 * h]) * t[2];
+                p[0] = b0 + b1;
+                p[h] = (b0 - b1) * t[0];
+                p[2 * h] = b2 + b3;
+                p[3 * h] = (b2 - b3) * t[0];
+            });
+        }
+    }
+
+    template <class T, class F>
+    void scale_by_inverse_size(std::span<T> a) {
+        const F n_inv = F(a.size()).inv();
+        for (auto &x : a) x = x * n_inv;
+    }
+
+    template <class T, class F = twiddle_field_t<T> >
+    void forward(std::span<T> a, bool threaded) {
+        if (a.size() <= 1) return;
+        auto twiddles = Twiddles<F>::get(a.size());
+        bit_reverse(a);
+        dit<T, F>(a, twiddles->passes, twiddles->forward, threaded);
+    }
+
+    template <class T, class F = twiddle_field_t<T> >
+    void inverse(std::span<T> a, bool threaded) {
+        if (a.size() <= 1) return;
+        auto twiddles = Twiddles<F>::get(a.size());
+        bit_reverse(a);
+        dit<T, F>(a, twiddles->passes, twiddles->inverse, threaded);
+        scale_by_inverse_size<T, F>(a);
+    }
+
+    inline bool split_stages(size_t n) {
+        return n >= PARALLEL_THRESHOLD && parallel::num_threads() > 1;
+    }
+
+    // Transforms over F at least this long take the four-step path, set from the ntt_2^N rows of
+    // bench_field (four_step against radix2). Only BabyBear comes out ahead, at 2^22; P128 and
+    // Goldilocks stay on radix-2 at every measured size.
+    template <class F>
+    inline size_t FOUR_STEP_THRESHOLD = SIZE_MAX;
+    template <>
+    inline size_t FOUR_STEP_THRESHOLD<BabyBearElement> = (size_t)1 << 22;
+
+    template <class T, class F, bool Inverse>
+    void four_step(std::span<T> a);
+
+    template <class T, class F = twiddle_field_t<T> >
+    void forward(std::span<T> a) {
+        if (a.size() >= FOUR_STEP_THRESHOLD<F>) four_step<T, F, false>(a);
+        else forward<T, F>(a, split_stages(a.size()));
+    }
+
+    template <class T, class F = twiddle_field_t<T> >
+    void inverse(std::span<T> a) {
+        if (a.size() >= FOUR_STEP_THRESHOLD<F>) four_step<T, F, true>(a);
+        else inverse<T, F>(a, split_stages(a.size()));
+    }
+
+    /*
+        The transform without the permutation: forward_to_bit_reversed() leaves the evaluations
+        in bit-reversed order and inverse_from_bit_reversed() takes them back from that order to
+        natural-order coefficients. A pointwise product in between does not care about the order,
+        so a convolution runs the two halves of the DIF/DIT pair and never permutes.
+    */
+    template <class T, class F = twiddle_field_t<T> >
+    void forward_to_bit_reversed(std::span<T> a, bool threaded) {
+        if (a.size() <= 1) return;
+        auto twiddles = Twiddles<F>::get(a.size());
+        dif<T, F>(a, twiddles->passes, twiddles->forward, threaded);
+    }
+
+    template <class T, class F = twiddle_field_t<T> >
+    void forward_to_bit_reversed(std::span<T> a) {
+        if (a.size() >= FOUR_STEP_THRESHOLD<F>) {
+            four_step<T, F, false>(a);
+            bit_reverse(a);
+        } else {
+            forward_to_bit_reversed<T, F>(a, split_stages(a.size()));
+        }
+    }
+
+    template <class T, class F = twiddle_field_t<T> >
+    void inverse_from_bit_reversed(std::span<T> a) {
+        if (a.size() <= 1) return;
+        if (a.size() >= FOUR_STEP_THRESHOLD<F>) {
+            bit_reverse(a);
+            four_step<T, F, true>(a);
+            return;
+        }
+        auto twiddles = Twiddles<F>::get(a.size());
+        dit<T, F>(a, twiddles->passes, twiddles->inverse, split_stages(a.size()));
+        scale_by_inverse_size<T, F>(a);
+    }
+
+    template <class T, class F = twiddle_field_t<T> >
+    void forward(vector<T> &a) {
+        forward<T, F>(std::span<T>(a));
+    }
+
+    template <class T, class F = twiddle_field_t<T> >
+    void inverse(vector<T> &a) {
+        inverse<T, F>(std::span<T>(a));
+    }
+
+    /*
+        Batched transforms over a column-major buffer: a holds a.size() / n columns of length n
+        back to back. With at least as many columns as threads every column is one serial
+        transform on its own thread; otherwise the columns go one at a time with their stages
+        split across the pool.
+    */
+    template <class T, class F = twiddle_field_t<T> >
+    void forward_columns(std::span<T> a, size_t n) {
+        const size_t columns = n == 0 ? 0 : a.size() / n;
+        if (columns >= parallel::num_threads()) {
+            parallel::for_each(columns, [&](size_t c) { forward<T, F>(a.subspan(c * n, n), false); });
+        } else {
+            for (size_t c = 0; c != columns; c++) forward<T, F>(a.subspan(c * n, n));
+        }
+    }
+
+    template <class T, class F = twiddle_field_t<T> >
+    void inverse_columns(std::span<T> a, size_t n) {
+        const size_t columns = n == 0 ? 0 : a.size() / n;
+        if (columns >= parallel::num_threads()) {
+            parallel::for_each(columns, [&](size_t c) { inverse<T, F>(a.subspan(c * n, n), false); });
+        } else {
+            for (size_t c = 0; c != columns; c++) inverse<T, F>(a.subspan(c * n, n));
+        }
+    }
+
+    // Columns four_step() gathers into one contiguous batch per task
+    inline size_t FOUR_STEP_BATCH = 16;
+
+    /*
+        Four-step (Bailey) transform for vectors too large for cache. With n = n1 * n2 and a viewed
+        as n1 rows of n2, X[k1 + n1 * k2] is a length-n2 transform over j2 of w^(j2 * k1) times the
+        length-n1 transform over j1 of column j2. Both steps gather a batch of adjacent columns
+        into a contiguous buffer, transform each and scatter it back:
+
+            1. columns of a to rows of t, each entry (j2, k1) multiplied by w^(j2 * k1) on the way,
+               so t is the twiddled column transforms transposed
+            2. columns of t, now the rows of the matrix, back into the same positions of a, where
+               X[k1 + n1 * k2] lands in natural order
+
+        so the whole transform reads and writes the vector twice. The inverse runs the same steps
+        with inverse sub-transforms, whose 1/n1 and 1/n2 scalings make 1/n, and w^-1.
+    */
+    template <class T, class F, bool Inverse>
+    void four_step(std::span<T> a) {
+        const size_t n = a.size(), k = log2_exact(n);
+        const size_t n1 = (size_t)1 << (k / 2), n2 = n / n1, batch = std::min(FOUR_STEP_BATCH, n1);
+        auto transform = [](std::span<T> column) {
+            if constexpr (Inverse) inverse<T, F>(column, false);
+            else forward<T, F>(column, false);
+        };
+
+        const F w = Inverse ? F::primitive_nth_root(n).inv() : F::primitive_nth_root(n);
+        vector<F> row_steps(n2);
+        F x = F(1);
+        for (auto &step : row_steps) {
+            step = x;
+            x = x * w;
+        }
+
+        vector<T> t(n);
+        parallel::for_each(n2 / batch, [&](size_t b) {
+            vector<T> columns(batch * n1);
+            for (size_t j1 = 0; j1 != n1; j1++) {
+                for (size_t c = 0; c != batch; c++) columns[c * n1 + j1] = a[j1 * n2 + b * batch + c];
+            }
+            for (size_t c = 0; c != batch; c++) {
+                const size_t j2 = b * batch + c;
+                transform(std::span<T>(columns).subspan(c * n1, n1));
+                T *row = t.data() + j2 * n1;
+                F twiddle = F(1);
+                for (size_t k1 = 0; k1 != n1; k1++) {
+                    row[k1] = columns[c * n1 + k1] * twiddle;
+                    twiddle = twiddle * row_steps[j2];
+                }
+            }
+        });
+
+        parallel::for_each(n1 / batch, [&](size_t b) {
+            vector<T> columns(batch * n2);
+            for (size_t j2 = 0; j2 != n2; j2++) {
+                for (size_t c = 0; c != batch; c++) columns[c * n2 + j2] = t[j2 * n1 + b * batch + c];
+            }
+            for (size_t c = 0; c != batch; c++) transform(std::span<T>(columns).subspan(c * n2, n2));
+            for (size_t k2 = 0; k2 != n2; k2++) {
+                for (size_t c = 0; c != batch; c++) a[k2 * n1 + b * batch + c] = columns[c * n2 + k2];
+            }
+        });
+    }
+}
+
+#endif
@@ -0,0 +1,152 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/*
+    Process-wide worker pool for data-parallel loops. for_range() cuts [0, n) into at most
+    num_threads() contiguous chunks of at least `grain` indices, runs one on the calling thread
+    and the rest on the pool, and returns when all are done. Every index is processed exactly
+    once by the same code whatever the split, so results do not depend on the thread count.
+    Loops started from inside a worker run serially instead of waiting on the pool. If any chunk
+    throws, for_range() still waits for the others and then rethrows the first exception.
+*/
+namespace parallel {
+    class ThreadPool {
+        public:
+            ThreadPool() {}
+
+            ~ThreadPool() {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    stopping = true;
+                }
+                wake.notify_all();
+                for (auto &t : threads) t.join();
+            }
+
+            ThreadPool(const ThreadPool&) = delete;
+            ThreadPool& operator=(const ThreadPool&) = delete;
+
+            size_t size() const { return threads.size(); }
+
+            // Not synchronized with itself; pool() serializes the calls
+            void grow(size_t workers) {
+                while (threads.size() < workers) threads.emplace_back([this] { run(); });
+            }
+
+            void submit(std::function<void()> task) {
+                {
+                    std::lock_guard<std::mutex> guard(lock);
+                    tasks.push(std::move(task));
+                }
+                wake.notify_one();
+            }
+
+            static bool in_worker() { return worker_flag(); }
+
+        private:
+            std::vector<std::thread> threads;
+            std::queue<std::function<void()> > tasks;
+            std::mutex lock;
+            std::condition_variable wake;
+            bool stopping = false;
+
+            static bool& worker_flag() {
+                static thread_local bool flag = false;
+                return flag;
+            }
+
+            void run() {
+                worker_flag() = true;
+                while (true) {
+                    std::function<void()> task;
+                    {
+                        std::unique_lock<std::mutex> guard(lock);
+                        wake.wait(guard, [this] { return stopping || !tasks.empty(); });
+                        if (tasks.empty()) return;
+                        task = std::move(tasks.front());
+                        tasks.pop();
+                    }
+                    task();
+                }
+            }
+    };
+
+    inline size_t& thread_count() {
+        static size_t count = std::max<size_t>(1, std::thread::hardware_concurrency());
+        return count;
+    }
+
+    inline size_t num_threads() { return thread_count(); }
+
+    // Takes effect for loops started afterwards; 1 runs everything on the calling thread
+    inline void set_num_threads(size_t n) { thread_count() = std::max<size_t>(1, n); }
+
+    // Workers are created on first use and kept; the pool grows if set_num_threads() asks for more
+    inline ThreadPool& pool(size_t workers) {
+        static std::mutex lock;
+        static ThreadPool instance;
+        std::lock_guard<std::mutex> guard(lock);
+        instance.grow(workers);
+        return instance;
+    }
+
+    // fn(begin, end) over a partition of [0, n)
+    template <class Fn>
+    void for_range(size_t n, size_t grain, Fn &&fn) {
+        if (n == 0) return;
+        size_t chunks = std::min(num_threads(), (n + grain - 1) / std::max<size_t>(grain, 1));
+        if (chunks <= 1 || ThreadPool::in_worker()) {
+            fn(size_t(0), n);
+            return;
+        }
+        ThreadPool &workers = pool(chunks - 1);
+        std::mutex lock;
+        std::condition_variable done;
+        size_t pending = chunks - 1;
+        std::exception_ptr error; // the first chunk to throw, rethrown once every chunk has finished
+        auto run = [&](size_t begin, size_t end) {
+            try {
+                if (begin != end) fn(begin, end);
+            } catch (...) {
+                std::lock_guard<std::mutex> guard(lock);
+                if (!error) error = std::current_exception();
+            }
+        };
+        const size_t step = (n + chunks - 1) / chunks;
+        for (size_t c = 1; c != chunks; c++) {
+            const size_t begin = std::min(n, c * step), end = std::min(n, begin + step);
+            workers.submit([&, begin, end] {
+                run(begin, end);
+                std::lock_guard<std::mutex> guard(lock);
+                if (--pending == 0) done.notify_one();
+            });
+        }
+        run(size_t(0), std::min(n, step));
+        {
+            // The queued chunks refer to this frame, so it cannot unwind before they are done
+            std::unique_lock<std::mutex> guard(lock);
+            done.wait(guard, [&] { return pending == 0; });
+        }
+        if (error) std::rethrow_exception(error);
+    }
+
+    // fn(i) for every i < n
+    template <class Fn>
+    void for_each(size_t n, Fn &&fn) {
+        for_range(n, 1, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i != end; i++) fn(i);
+        });
+    }
+}
+
+#endif
@@ -4,138 +4,155 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <algorithm>
+#include <mutex>
 #include "ttmath/ttmath.h"
 #include "Field.hpp"
+#include "FieldKernels.hpp"
+#include "Convolution.hpp"
+#include "Division.hpp"
+#include "Domain.hpp"
+#include "NTT.hpp"
 
 using std::vector;
 using std::string;
 
-class Polynomial{
+template <typename F>
+class BasicPolynomial {
 
 public:
-    vector<FieldElement> coeffs;
-    Polynomial() {coeffs = vector<FieldElement>(0);} 
-    Polynomial(const vector<FieldElement>& coeffs) : coeffs(coeffs) {}
-    Polynomial(const FieldElement& c) {
-        coeffs = vector<FieldElement>{c};
+    // Never has trailing zeros, so the zero polynomial is empty and degree() is coeffs.size() - 1.
+    // Every constructor and operator keeps this; code that edits coeffs directly calls normalize().
+    vector<F> coeffs;
+    BasicPolynomial() {coeffs = vector<F>(0);} 
+    BasicPolynomial(const vector<F>& coeffs) : coeffs(coeffs) {
+        normalize();
+    }
+    BasicPolynomial(vector<F>&& coeffs) : coeffs(std::move(coeffs)) {
+        normalize();
+    }
+    BasicPolynomial(const F& c) {
+        if (c != F(0)) coeffs = vector<F>{c};
+    }
+
+    void normalize() {
+        while (!coeffs.empty() && coeffs.back() == F(0)) coeffs.pop_back();
     }
 
     int64_t degree() const {
-        if (coeffs.empty()) return -1;
+        return static_cast<int64_t>(coeffs.size()) - 1;
+    }
 
-        bool flag = true;
-        for (auto& coeff : coeffs) {
-            if (coeff != FieldElement(0)) {
-                flag = false;
-                break;
-            }
-        }
-        if (flag) return -1;
-        FieldElement zero = FieldElement(0);
-        int64_t max_index = 0;
-        if (coeffs[0] != zero) max_index = 0;
-        for (int64_t i = 0; i < coeffs.size(); i++) {
-            if (coeffs[i] != zero) {
-                max_index = i;
-            }
-        }
-        return max_index;
+    BasicPolynomial operator-() const & {
+        BasicPolynomial result = *this;
+        return -std::move(result);
     }
 
-    Polynomial operator-() const {
-        vector<FieldElement> neg_coeffs;
-        for (const auto& coeff : coeffs) {
-            neg_coeffs.push_back(-coeff);
-        }
-        return Polynomial(neg_coeffs);
+    BasicPolynomial operator-() && {
+        for (auto& coeff : coeffs) coeff = -coeff;
+        return std::move(*this);
     }
 
-    Polynomial operator+(const Polynomial &other) const {
-        if (this->degree() == -1) return other;
-        else if (other.degree() == -1) return *this;
-        
-        vector<FieldElement> new_coeffs(std::max(this->coeffs.size(), other.coeffs.size()), FieldElement(0));
-        for (size_t i = 0; i != this->coeffs.size(); i++) {
-            new_coeffs[i] = this->coeffs[i];
-        }
-        for (size_t i = 0; i != other.coeffs.size(); i++) {
-            new_coeffs[i] = new_coeffs[i] + other.coeffs[i];
-        }
+    BasicPolynomial& operator+=(const BasicPolynomial &other) {
+        if (other.coeffs.size() > this->coeffs.size()) this->coeffs.resize(other.coeffs.size(), F(0));
+        kernels::add<F>(std::span<F>(this->coeffs).first(other.coeffs.size()), std::span<const F>(this->coeffs).first(other.coeffs.size()), other.coeffs);
+        normalize();
+        return *this;
+    }
 
-        return Polynomial(new_coeffs);
-    }   
+    BasicPolynomial& operator-=(const BasicPolynomial &other) {
+        if (other.coeffs.size() > this->coeffs.size()) this->coeffs.resize(other.coeffs.size(), F(0));
+        kernels::sub<F>(std::span<F>(this->coeffs).first(other.coeffs.size()), std::span<const F>(this->coeffs).first(other.coeffs.size()), other.coeffs);
+        normalize();
+        return *this;
+    }
 
-    Polynomial operator-(const Polynomial &other) const {
-        return this->operator+(-other);
+    BasicPolynomial& operator*=(const BasicPolynomial &other) {
+        if (this->degree() == -1 || other.degree() == -1) this->coeffs.clear();
+        else this->coeffs = convolution::multiply(this->coeffs, other.coeffs);
+        return *this;
     }
 
-    Polynomial operator*(const Polynomial &other) const {
-        if (this->degree() == -1 || other.degree() == -1) return Polynomial();
-        vector<FieldElement> new_coeffs(this->coeffs.size() + other.coeffs.size() - 1, FieldElement(0));
-        for (size_t i = 0; i != this->coeffs.size(); i++) {
-            if (this->coeffs[i] == FieldElement(0)) continue;
-            for (size_t j = 0; j != other.coeffs.size(); j++) {
-                new_coeffs[i + j] = new_coeffs[i + j] + (this->coeffs[i] * other.coeffs[j]);
-            }
+    BasicPolynomial& operator*=(const F &other) {
+        if (other == F(0)) this->coeffs.clear();
+        else kernels::scalar_mul(this->coeffs, this->coeffs, other);
+        return *this;
+    }
+
+    // The value-returning operators reuse an rvalue left operand's storage
+    BasicPolynomial operator+(const BasicPolynomial &other) const & {
+        if (other.coeffs.size() > this->coeffs.size()) {
+            BasicPolynomial result = other;
+            return std::move(result += *this);
         }
-        return Polynomial(new_coeffs);
+        BasicPolynomial result = *this;
+        return std::move(result += other);
     }
 
-    Polynomial operator*(const FieldElement &other) const {
-        Polynomial other_poly = Polynomial(vector<FieldElement>{other});
-        return this->operator*(other_poly);
+    BasicPolynomial operator+(const BasicPolynomial &other) && {
+        return std::move(*this += other);
     }
 
-    bool operator==(const Polynomial &other) const {
-        if (this->degree() != other.degree()) return false;
-        if (this->degree() == -1) return true;
+    BasicPolynomial operator-(const BasicPolynomial &other) const & {
+        BasicPolynomial result = *this;
+        return std::move(result -= other);
+    }
 
-        for (size_t i = 0; i != this->degree() + 1; i++) {
-            if (this->coeffs[i] != other.coeffs[i]) return false;
-        }
-        return true;
+    BasicPolynomial operator-(const BasicPolynomial &other) && {
+        return std::move(*this -= other);
     }
 
-    bool operator!=(const Polynomial &other) const {
+    BasicPolynomial operator*(const BasicPolynomial &other) const {
+        if (this->degree() == -1 || other.degree() == -1) return BasicPolynomial();
+        return BasicPolynomial(convolution::multiply(this->coeffs, other.coeffs));
+    }
+
+    BasicPolynomial operator*(const F &other) const & {
+        BasicPolynomial result = *this;
+        return std::move(result *= other);
+    }
+
+    BasicPolynomial operator*(const F &other) && {
+        return std::move(*this *= other);
+    }
+
+    bool operator==(const BasicPolynomial &other) const {
+        return this->coeffs == other.coeffs;
+    }
+
+    bool operator!=(const BasicPolynomial &other) const {
         return !(this->operator==(other));
     }
 
-    FieldElement leading_coefficient() const {
-        return this->coeffs[static_cast<size_t>(this->degree())];
+    F leading_coefficient() const {
+        return this->coeffs.back();
     }
 
-    void divided_by(const Polynomial& other, Polynomial& quotient, Polynomial &remainder) const {
+    void divided_by(const BasicPolynomial& other, BasicPolynomial& quotient, BasicPolynomial &remainder) const {
         if (other.degree() == -1) {
             throw std::invalid_argument("Divisor cannot be zero polynomial");
         }
         if (this->degree() < other.degree()) {
-            quotient = Polynomial();
+            quotient = BasicPolynomial();
             remainder = *this;
             return;
         }
+        vector<F> q, r;
+        division::divide(this->coeffs, other.coeffs, q, r);
+        quotient.coeffs = std::move(q);
+        remainder.coeffs = std::move(r);
+    }
 
-        Polynomial tmpremainder = *this;
-        vector<FieldElement> quotient_coeffs(this->degree() - other.degree() + 1, FieldElement(0));
-        for (size_t i = 0; i != this->degree() - other.degree() + 1; i++) {
-            if (tmpremainder.degree() < other.degree()) break;
-            FieldElement coeff = tmpremainder.leading_coefficient() / other.leading_coefficient();
-            size_t degree_shift = tmpremainder.degree() - other.degree();
-            vector<FieldElement> subtractee_vec(degree_shift, FieldElement(0));
-            subtractee_vec.push_back(coeff);
-            Polynomial subtractee = Polynomial(subtractee_vec) * other;
-            quotient_coeffs[degree_shift] = coeff;
-            tmpremainder = tmpremainder - subtractee;
-        }
-        quotient = Polynomial(quotient_coeffs);
-        remainder = tmpremainder;
-        if (remainder.degree() == -1) {
-            remainder = Polynomial(vector<FieldElement>{FieldElement(0)});
-        }
-        return;
+    // Division by a polynomial whose inverse has already been precomputed
+    void divided_by(const division::Divisor<F>& other, BasicPolynomial& quotient, BasicPolynomial &remainder) const {
+        vector<F> q, r;
+        other.divide(this->coeffs, q, r);
+        quotient.coeffs = std::move(q);
+        remainder.coeffs = std::move(r);
     }
 
-    Polynomial operator/(const Polynomial& other) const {
-        Polynomial quotient, remainder;
+    BasicPolynomial operator/(const BasicPolynomial& other) const {
+        BasicPolynomial quotient, remainder;
         this->divided_by(other, quotient, remainder);
         if (remainder.degree() != -1) {
             throw std::invalid_argument("Remainder is not zero");
@@ -143,43 +160,54 @@ public:
         return quotient;
     }
 
-    Polynomial operator/(const FieldElement& other) const {
-        if (other == FieldElement(0)) {
+    BasicPolynomial operator/(const F& other) const {
+        if (other == F(0)) {
             throw std::invalid_argument("Divisor cannot be zero");
         }
-        vector<FieldElement> new_coeffs;
-        for (const auto& coeff : this->coeffs) {
-            new_coeffs.push_back(coeff / other);
+        return *this * other.inv();
+    }
+
+    BasicPolynomial operator%(const BasicPolynomial& other) const {
+        BasicPolynomial quotient, remainder;
+        this->divided_by(other, quotient, remainder);
+        return remainder;
+    }
+
+    BasicPolynomial operator/(const division::Divisor<F>& other) const {
+        BasicPolynomial quotient, remainder;
+        this->divided_by(other, quotient, remainder);
+        if (remainder.degree() != -1) {
+            throw std::invalid_argument("Remainder is not zero");
         }
-        return Polynomial(new_coeffs);
+        return quotient;
     }
 
-    Polynomial operator%(const Polynomial& other) const {
-        Polynomial quotient, remainder;
+    BasicPolynomial operator%(const division::Divisor<F>& other) const {
+        BasicPolynomial quotient, remainder;
         this->divided_by(other, quotient, remainder);
         return remainder;
     }
 
-    Polynomial operator^(const BigInt& other) const {
+    BasicPolynomial operator^(const BigInt& other) const {
         if (this->degree() == -1 && other == 0) throw std::invalid_argument("Zero polynomial cannot be raised to power 0");
-        if (this->degree() == -1) return Polynomial();
+        if (this->degree() == -1) return BasicPolynomial();
 
-        if (other == 0) return Polynomial(vector<FieldElement>(1, FieldElement(1)));
+        if (other == 0) return BasicPolynomial(vector<F>(1, F(1)));
 
-        Polynomial result = Polynomial(vector<FieldElement>(1, FieldElement(1)));
-        Polynomial base = *this;
+        BasicPolynomial result = BasicPolynomial(vector<F>(1, F(1)));
+        BasicPolynomial base = *this;
         BigInt exp = other;
-        while (exp != 0 && base != Polynomial(vector<FieldElement>(1, FieldElement(1)))) {
-            if (exp % 2 == 1) result = result * base;
-            base = base * base;
+        while (exp != 0 && base != BasicPolynomial(vector<F>(1, F(1)))) {
+            if (exp % 2 == 1) result *= base;
+            base *= base;
             exp = exp >> 1;
         }
         return result;
     }
 
-    FieldElement operator[](const FieldElement& x) const { // evaluate polynomial at a given point
-        FieldElement result = FieldElement(0);
-        FieldElement x_i = FieldElement(1);
+    F operator[](const F& x) const { // evaluate polynomial at a given point
+        F result = F(0);
+        F x_i = F(1);
         for (auto & coeff : coeffs) {
             result = result + (coeff * x_i);
             x_i = x_i * x;
@@ -187,20 +215,27 @@ public:
         return result;
     }
 
-    vector<FieldElement> evaluate_domain(const vector<FieldElement>& domain) const {
-        vector<FieldElement> result;
-        for (auto & x : domain) {
-            result.push_back(this->operator[](x));
+    // Horner's rule across the whole domain at once, one vectorized multiplication per coefficient
+    vector<F> evaluate_domain(const vector<F>& domain) const {
+        vector<F> result(domain.size(), F(0));
+        for (size_t k = this->coeffs.size(); k-- != 0;) {
+            kernels::mul(result, result, domain);
+            for (auto& r : result) r = r + this->coeffs[k];
         }
         return result;
     }
 
-    Polynomial scale(const FieldElement& scalar) const {
-        vector<FieldElement> new_coeffs;
-        for (const auto& coeff : this->coeffs) {
-            new_coeffs.push_back(coeff * scalar);
+    BasicPolynomial derivative() const {
+        if (this->coeffs.size() <= 1) return BasicPolynomial();
+        vector<F> new_coeffs(this->coeffs.size() - 1);
+        for (size_t i = 1; i != this->coeffs.size(); i++) {
+            new_coeffs[i - 1] = this->coeffs[i] * F(i);
         }
-        return Polynomial(new_coeffs);
+        return BasicPolynomial(new_coeffs);
+    }
+
+    BasicPolynomial scale(const F& scalar) const {
+        return *this * scalar;
     }
 
     operator string() const {
@@ -217,46 +252,341 @@ public:
 
 };
 
-Polynomial interpolate_domain(const vector<FieldElement> &domain, const vector<FieldElement> &values) {
+// a += s * b without materializing s * b
+template <class F>
+void axpy(BasicPolynomial<F> &a, const F &s, const BasicPolynomial<F> &b) {
+    if (b.coeffs.size() > a.coeffs.size()) a.coeffs.resize(b.coeffs.size(), F(0));
+    kernels::axpy<F, F>(std::span<F>(a.coeffs).first(b.coeffs.size()), s, b.coeffs);
+    a.normalize();
+}
+
+using Polynomial = BasicPolynomial<FieldElement>;
+
+// Interpolation over a whole coset offset * <omega>: one inverse NTT, then c_i / offset^i
+template <class F>
+BasicPolynomial<F> interpolate_subgroup(const Domain<F> &domain, const vector<F> &values) {
     if (domain.size() != values.size()) {
         throw std::invalid_argument("Domain and values must have the same size");
     }
-    Polynomial result = Polynomial();
-    Polynomial x(vector<FieldElement>{FieldElement(0), FieldElement(1)});
-    
-    for (size_t i = 0; i != domain.size(); i++) {
-        Polynomial prod = Polynomial(vector<FieldElement>{FieldElement(values[i])});
-        for (size_t j = 0; j != domain.size(); j++) {
-            if (j == i) continue;
-            prod = prod * (x - Polynomial(vector<FieldElement>{(domain[j])})) * Polynomial(vector<FieldElement>{(domain[i] - domain[j]).inv()});
+    vector<F> coeffs = values;
+    NTT::inverse(coeffs);
+    if (domain.offset() != F(1)) {
+        F offset_inv = domain.offset().inv(), scale = F(1);
+        for (auto &c : coeffs) {
+            c = c * scale;
+            scale = scale * offset_inv;
         }
-        result = result + prod;
     }
-    return result;
+    return BasicPolynomial<F>(coeffs);
 }
 
-Polynomial zerofier_domain(vector<FieldElement> domain) {
-    Polynomial x(vector<FieldElement>{FieldElement(0), FieldElement(1)});
-    Polynomial result(vector<FieldElement>{FieldElement(1)});
+// offset^0 .. offset^{n-1}
+template <class F>
+vector<F> power_table(const F &offset, size_t n) {
+    vector<F> powers(n);
+    F x = F(1);
+    for (auto &p : powers) {
+        p = x;
+        x = x * offset;
+    }
+    return powers;
+}
+
+/*
+    Low-degree extension without transforming zeros. With size = B * n for n the smallest power
+    of two covering the coefficients, the point offset * omega^(r + B k) of the LDE domain is
+    (offset * omega^r) * nu^k for nu = omega^B of order n: the domain is B cosets of <nu>, and
+    each takes one length-n NTT of c_i offset^i omega^(r i). That is B * n log n butterflies
+    instead of size * log size over a vector that is mostly padding.
+
+    Index r + B k reversed over log2 size bits is rev(r) * n + rev(k), so with every coset
+    transformed to bit-reversed order in block rev(r) of the output, the output is the whole
+    transform in bit-reversed order and one permutation finishes it. No scratch is needed
+    besides the output.
+
+    lde_coset() computes coset r from scaled[i] = c_i offset^i (indices folded mod n when the
+    polynomial is longer); roots[j] = omega^j.
+*/
+inline size_t lde_block_size(size_t length, size_t size) {
+    size_t n = 1;
+    while (n < length && n < size) n <<= 1;
+    return n;
+}
+
+template <class F>
+void lde_coset(std::span<const F> scaled, const vector<F> &roots, size_t r, size_t n, std::span<F> out, bool threaded) {
+    const size_t size = roots.size(), cosets = size / n;
+    size_t block_index = 0;
+    for (size_t bit = 1; bit < cosets; bit <<= 1) {
+        block_index = (block_index << 1) | ((r & bit) != 0);
+    }
+    std::span<F> block = out.subspan(block_index * n, n);
+    std::fill(block.begin(), block.end(), F(0));
+    for (size_t i = 0, j = 0; i != scaled.size(); i++, j = (j + r) & (size - 1)) {
+        const F x = r == 0 ? scaled[i] : scaled[i] * roots[j];
+        if (i < n) block[i] = x;
+        else block[i & (n - 1)] = block[i & (n - 1)] + x;
+    }
+    if (threaded) NTT::forward_to_bit_reversed<F>(block);
+    else NTT::forward_to_bit_reversed<F>(block, false);
+}
+
+// Evaluations on offset * <omega> for omega of order size, one small NTT per coset as above
+template <class F>
+vector<F> coset_lde(const BasicPolynomial<F> &poly, const F &offset, size_t size) {
+    if (poly.degree() == -1) return vector<F>(size, F(0));
+    vector<F> scaled = poly.coeffs;
+    if (offset != F(1)) kernels::mul(scaled, scaled, power_table(offset, scaled.size()));
+    const size_t n = lde_block_size(scaled.size(), size), cosets = size / n;
+    const vector<F> &roots = Domain<F>::subgroup(size)->elements();
+    vector<F> values(size);
+    if (cosets >= parallel::num_threads()) {
+        parallel::for_each(cosets, [&](size_t r) { lde_coset<F>(scaled, roots, r, n, values, false); });
+    } else {
+        for (size_t r = 0; r != cosets; r++) lde_coset<F>(scaled, roots, r, n, values, true);
+    }
+    NTT::bit_reverse<F>(values);
+    return values;
+}
+
+template <class F>
+vector<F> coset_lde(const BasicPolynomial<F> &poly, const Domain<F> &domain) {
+    return coset_lde(poly, domain.offset(), domain.size());
+}
+
+// interpolate_subgroup for many columns over one domain. The columns are packed column-major into
+// one buffer for a batched inverse NTT and share a single table of offset^-i.
+template <class F>
+vector<BasicPolynomial<F> > interpolate_subgroup_columns(const Domain<F> &domain, const vector<vector<F> > &columns) {
+    const size_t n = domain.size();
+    for (const auto &column : columns) {
+        if (column.size() != n) throw std::invalid_argument("Domain and values must have the same size");
+    }
+    vector<F> buffer(columns.size() * n);
+    parallel::for_each(columns.size(), [&](size_t c) {
+        std::copy(columns[c].begin(), columns[c].end(), buffer.begin() + c * n);
+    });
+    NTT::inverse_columns<F>(buffer, n);
+
+    const vector<F> scales = domain.offset() == F(1) ? vector<F>() : power_table(domain.offset().inv(), n);
+    vector<BasicPolynomial<F> > polys(columns.size());
+    parallel::for_each(columns.size(), [&](size_t c) {
+        vector<F> coeffs(buffer.begin() + c * n, buffer.begin() + (c + 1) * n);
+        if (!scales.empty()) kernels::mul(coeffs, coeffs, scales);
+        polys[c] = BasicPolynomial<F>(std::move(coeffs));
+    });
+    return polys;
+}
+
+// coset_lde for many polynomials onto one domain. Every (polynomial, coset) pair is an
+// independent small transform into its block of the codeword, so the only size-long buffers are
+// the outputs.
+template <class F>
+vector<vector<F> > coset_lde_columns(const vector<BasicPolynomial<F> > &polys, const Domain<F> &domain) {
+    const size_t size = domain.size();
+    size_t longest = 0;
+    for (const auto &poly : polys) longest = std::max(longest, poly.coeffs.size());
+    if (longest == 0) return vector<vector<F> >(polys.size(), vector<F>(size, F(0)));
+    const vector<F> scales = power_table(domain.offset(), longest);
+    const size_t n = lde_block_size(longest, size), cosets = size / n;
+    const vector<F> &roots = Domain<F>::subgroup(size)->elements();
+
+    vector<vector<F> > scaled(polys.size()), codewords(polys.size());
+    parallel::for_each(polys.size(), [&](size_t c) {
+        scaled[c] = polys[c].coeffs;
+        kernels::mul<F, F>(scaled[c], scaled[c], std::span<const F>(scales).first(scaled[c].size()));
+        codewords[c].resize(size);
+    });
+    const size_t tasks = polys.size() * cosets;
+    if (tasks >= parallel::num_threads()) {
+        parallel::for_each(tasks, [&](size_t t) {
+            lde_coset<F>(scaled[t / cosets], roots, t % cosets, n, codewords[t / cosets], false);
+        });
+    } else {
+        for (size_t t = 0; t != tasks; t++) lde_coset<F>(scaled[t / cosets], roots, t % cosets, n, codewords[t / cosets], true);
+    }
+    parallel::for_each(polys.size(), [&](size_t c) { NTT::bit_reverse<F>(codewords[c]); });
+    return codewords;
+}
+
+// Point sets at least this large go through a SubproductTree in zerofier_domain and interpolate_domain
+inline size_t SUBPRODUCT_TREE_THRESHOLD = 64;
+
+/*
+    Subproduct tree over arbitrary points x_0 .. x_{n-1}. Level 0 holds the factors X - x_i and
+    each level above the products of adjacent pairs (an unpaired node is carried up unchanged),
+    so node i of level l is the zerofier of x_{i*2^l} .. x_{(i+1)*2^l - 1} and the root is the
+    zerofier of the whole set. Multipoint evaluation reduces modulo the nodes on the way down,
+    reusing each node's precomputed Newton inverse across calls;
+    interpolation combines weighted leaves on the way up. Both cost O(M(n) log n) for M the
+    multiplication / division cost at the top level.
+*/
+template <class F>
+class SubproductTree {
+    public:
+        // Below this many points a node is evaluated directly with Horner's rule
+        static constexpr size_t LEAF_SIZE = 16;
+
+        explicit SubproductTree(const vector<F>& points) : points(points) {
+            vector<BasicPolynomial<F> > leaves;
+            for (const auto& x : points) leaves.push_back(BasicPolynomial<F>(vector<F>{-x, F(1)}));
+            if (leaves.empty()) leaves.push_back(BasicPolynomial<F>(F(1)));
+            levels.push_back(leaves);
+            while (levels.back().size() > 1) {
+                const auto& below = levels.back();
+                vector<BasicPolynomial<F> > level;
+                for (size_t i = 0; i < below.size(); i += 2) {
+                    level.push_back(i + 1 < below.size() ? below[i] * below[i + 1] : below[i]);
+                }
+                levels.push_back(std::move(level));
+            }
+        }
+
+        size_t size() const { return points.size(); }
+
+        const BasicPolynomial<F>& zerofier() const { return levels.back()[0]; }
+
+        // poly(x_i) for every point
+        vector<F> evaluate(const BasicPolynomial<F>& poly) const {
+            vector<F> result(points.size());
+            if (points.empty()) return result;
+            std::call_once(divisors_once, [this] {
+                for (const auto& level : levels) {
+                    divisors.emplace_back();
+                    for (const auto& node : level) divisors.back().emplace_back(node.coeffs);
+                }
+            });
+            evaluate_node(poly % divisors.back()[0], levels.size() - 1, 0, result);
+            return result;
+        }
+
+        // The polynomial of degree < n through (x_i, values[i]), from the Lagrange weights
+        // values[i] / Z'(x_i) with Z the root
+        BasicPolynomial<F> interpolate(const vector<F>& values) const {
+            if (values.size() != points.size()) {
+                throw std::invalid_argument("Domain and values must have the same size");
+            }
+            if (points.empty()) return BasicPolynomial<F>();
+            vector<F> weights = evaluate(zerofier().derivative());
+            for (const auto& w : weights) {
+                if (w == F(0)) throw std::invalid_argument("Interpolation points must be distinct");
+            }
+            batch_inverse(weights);
+            vector<BasicPolynomial<F> > nodes(points.size());
+            for (size_t i = 0; i != points.size(); i++) nodes[i] = BasicPolynomial<F>(values[i] * weights[i]);
+            for (size_t l = 0; l + 1 < levels.size(); l++) {
+                const auto& zerofiers = levels[l];
+                vector<BasicPolynomial<F> > next;
+                for (size_t i = 0; i < nodes.size(); i += 2) {
+                    if (i + 1 == nodes.size()) {
+                        next.push_back(std::move(nodes[i]));
+                        continue;
+                    }
+                    nodes[i] *= zerofiers[i + 1];
+                    nodes[i + 1] *= zerofiers[i];
+                    nodes[i] += nodes[i + 1];
+                    next.push_back(std::move(nodes[i]));
+                }
+                nodes = std::move(next);
+            }
+            return nodes[0];
+        }
+
+    private:
+        vector<F> points;
+        vector<vector<BasicPolynomial<F> > > levels;
+        // Every node with its precomputed inverse, built on the first evaluation
+        mutable std::once_flag divisors_once;
+        mutable vector<vector<division::Divisor<F> > > divisors;
+
+        // remainder is already reduced modulo node i of level l
+        void evaluate_node(const BasicPolynomial<F>& remainder, size_t l, size_t i, vector<F>& out) const {
+            const size_t begin = i << l, end = std::min(points.size(), (i + 1) << l);
+            if (end - begin <= LEAF_SIZE) {
+                vector<F> xs(points.begin() + begin, points.begin() + end);
+                vector<F> ys = remainder.evaluate_domain(xs);
+                std::copy(ys.begin(), ys.end(), out.begin() + begin);
+                return;
+            }
+            const auto& below = divisors[l - 1];
+            if (2 * i + 1 == below.size()) {
+                evaluate_node(remainder, l - 1, 2 * i, out);
+                return;
+            }
+            evaluate_node(remainder % below[2 * i], l - 1, 2 * i, out);
+            evaluate_node(remainder % below[2 * i + 1], l - 1, 2 * i + 1, out);
+        }
+};
+
+template <class F = FieldElement>
+BasicPolynomial<F> zerofier_domain(vector<F> domain) {
+    if (domain.size() >= SUBPRODUCT_TREE_THRESHOLD) return SubproductTree<F>(domain).zerofier();
+
+    BasicPolynomial<F> factor(vector<F>{F(0), F(1)});
+    BasicPolynomial<F> result(F(1));
 
     for (auto & x_i : domain) {
-        result = result * (x - Polynomial(vector<FieldElement>{x_i}));
+        factor.coeffs[0] = -x_i;
+        result *= factor;
     }
     return result;
 }
 
-bool test_colinearity(const vector<FieldElement>& domain, const vector<FieldElement>& values) {
+// Dispatches to interpolate_subgroup when the points are exactly omega^0 .. omega^{n-1}, and to a
+// SubproductTree for other large point sets
+template <class F = FieldElement>
+BasicPolynomial<F> interpolate_domain(const vector<F> &domain, const vector<F> &values) {
+    if (domain.size() != values.size()) {
+        throw std::invalid_argument("Domain and values must have the same size");
+    }
+    if constexpr (requires { F::primitive_nth_root(1); }) {
+        const size_t n = domain.size();
+        if (n > 1 && (n & (n - 1)) == 0 && n <= NTT::max_size<F>() && domain[0] == F(1) &&
+            domain[1] == F::primitive_nth_root(n)) {
+            auto subgroup = Domain<F>::subgroup(n);
+            if (domain == subgroup->elements()) return interpolate_subgroup(*subgroup, values);
+        }
+    }
+    if (domain.size() >= SUBPRODUCT_TREE_THRESHOLD) return SubproductTree<F>(domain).interpolate(values);
+
+    // Lagrange denominators prod_{j != i} (x_i - x_j), inverted together
+    vector<F> denominators(domain.size(), F(1));
+    for (size_t i = 0; i != domain.size(); i++) {
+        for (size_t j = 0; j != domain.size(); j++) {
+            if (j == i) continue;
+            denominators[i] = denominators[i] * (domain[i] - domain[j]);
+        }
+    }
+    batch_inverse(denominators);
+    
+    // prod_{j != i} (x - x_j) is Z / (x - x_i) for Z = prod_j (x - x_j), built once; each
+    // quotient is one synthetic division, so the whole interpolation is O(n^2)
+    const size_t n = domain.size();
+    const vector<F> z = zerofier_domain(domain).coeffs;
+    vector<F> result(n, F(0)), quotient(n);
+    for (size_t i = 0; i != n; i++) {
+        quotient[n - 1] = z[n];
+        for (size_t k = n - 1; k != 0; k--) quotient[k - 1] = z[k] + domain[i] * quotient[k];
+        const F c = values[i] * denominators[i];
+        for (size_t k = 0; k != n; k++) result[k] = result[k] + c * quotient[k];
+    }
+    return BasicPolynomial<F>(std::move(result));
+}
+
+template <class F = FieldElement>
+bool test_colinearity(const vector<F>& domain, const vector<F>& values) {
     if (domain.size() != values.size()) {
         throw std::invalid_argument("Domain and values must have the same size");
     }
     if (domain.size() < 2) return true;
     
-    Polynomial p = interpolate_domain(domain, values);
+    BasicPolynomial<F> p = interpolate_domain(domain, values);
     return p.degree() <= 1;
 }
 
 
-std::ostream& operator<<(std::ostream& os, const Polynomial& p) {
+template <class F>
+std::ostream& operator<<(std::ostream& os, const BasicPolynomial<F>& p) {
     int deg = p.degree();
 
     // Handle the zero polynomial case
@@ -266,7 +596,7 @@ std::ostream& operator<<(std::ostream& os, const Polynomial& p) {
     }
 
     // Handle constant zero polynomial case (if represented as {0})
-    if (deg == 0 && p.coeffs[0] == FieldElement(0)) {
+    if (deg == 0 && p.coeffs[0] == F(0)) {
          os << "0";
          return os;
     }
@@ -276,10 +606,10 @@ std::ostream& operator<<(std::ostream& os, const Polynomial& p) {
 
     // Iterate from the highest degree term down to the constant term
     for (int i = deg; i >= 0; --i) {
-        FieldElement coeff = p.coeffs[static_cast<size_t>(i)];
-        FieldElement zero(0);
-        FieldElement one(1);
-        FieldElement neg_one = -one; // Calculate -1 mod P
+        F coeff = p.coeffs[static_cast<size_t>(i)];
+        F zero(0);
+        F one(1);
+        F neg_one = -one; // Calculate -1 mod P
 
         // Skip terms with zero coefficients
         if (coeff == zero) {
@@ -289,8 +619,8 @@ std::ostream& operator<<(std::ostream& os, const Polynomial& p) {
         // --- Handle '+' sign ---
         if (!first_term) {
             // Print " + " only if the coefficient isn't negative
-            // If coeff is negative, the '-' will come from the FieldElement output
-            // Note: This relies on FieldElement's operator<< printing negatives correctly.
+            // If coeff is negative, the '-' will come from the F output
+            // Note: This relies on F's operator<< printing negatives correctly.
             // A more robust way handles the sign explicitly here.
 
             // Let's handle sign explicitly for better formatting:
@@ -0,0 +1,203 @@
+#ifndef SPARSE_POLYNOMIAL_HPP
+#define SPARSE_POLYNOMIAL_HPP
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include "Field.hpp"
+#include "Domain.hpp"
+#include "Polynomial.hpp"
+
+using std::vector;
+using std::pair;
+
+/*
+    Polynomial stored as its nonzero terms (exponent, coefficient) in increasing exponent order.
+    Zerofiers of subgroups are sparse -- x^n - 1 has two terms -- so they are described in O(1),
+    evaluated at a point in O(log n), and multiply into or divide a dense polynomial in
+    O(n * terms) without ever being expanded.
+*/
+template <typename F>
+class SparsePolynomial {
+
+public:
+    vector<pair<size_t, F> > terms;
+
+    SparsePolynomial() {}
+    SparsePolynomial(const vector<pair<size_t, F> >& unordered) {
+        vector<pair<size_t, F> > sorted = unordered;
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+        for (const auto& term : sorted) {
+            if (!terms.empty() && terms.back().first == term.first) terms.back().second = terms.back().second + term.second;
+            else terms.push_back(term);
+            if (terms.back().second == F(0)) terms.pop_back();
+        }
+    }
+
+    // x^n - 1, the zerofier of the subgroup of order n
+    static SparsePolynomial subgroup_zerofier(size_t n) {
+        return SparsePolynomial(vector<pair<size_t, F> >{{0, -F(1)}, {n, F(1)}});
+    }
+
+    int64_t degree() const {
+        return terms.empty() ? -1 : static_cast<int64_t>(terms.back().first);
+    }
+
+    F leading_coefficient() const {
+        return terms.back().second;
+    }
+
+    F operator[](const F& x) const {
+        F result = F(0);
+        for (const auto& [e, c] : terms) result = result + c * (x ^ (unsigned long long)e);
+        return result;
+    }
+
+    // Values on offset * <omega>. The term c x^e takes c offset^e (omega^e)^j, which repeats
+    // with period size / gcd(size, e), so only one period of each term is computed.
+    vector<F> evaluate_domain(const Domain<F>& domain) const {
+        const size_t size = domain.size();
+        vector<F> result(size, F(0));
+        for (const auto& [e, c] : terms) {
+            const size_t period = e == 0 ? 1 : size >> std::min<size_t>(__builtin_ctzll(e), __builtin_ctzll(size));
+            const F step = domain.generator() ^ (unsigned long long)e;
+            vector<F> values(period);
+            F x = c * (domain.offset() ^ (unsigned long long)e);
+            for (size_t j = 0; j != period; j++) {
+                values[j] = x;
+                x = x * step;
+            }
+            for (size_t j = 0; j != size; j++) result[j] = result[j] + values[j % period];
+        }
+        return result;
+    }
+
+    BasicPolynomial<F> dense() const {
+        if (terms.empty()) return BasicPolynomial<F>();
+        vector<F> coeffs(terms.back().first + 1, F(0));
+        for (const auto& [e, c] : terms) coeffs[e] = c;
+        return BasicPolynomial<F>(coeffs);
+    }
+
+    bool operator==(const SparsePolynomial& other) const {
+        return terms == other.terms;
+    }
+
+    bool operator!=(const SparsePolynomial& other) const {
+        return !(this->operator==(other));
+    }
+
+    operator string() const {
+        string result = "";
+        for (size_t i = 0; i != terms.size(); i++) {
+            if (i != 0) result += " + ";
+            result += (string)terms[i].second + "x^" + std::to_string(terms[i].first);
+        }
+        return result;
+    }
+};
+
+// O(n * terms): every term shifts and scales a copy of a into the result
+template <class F>
+BasicPolynomial<F> operator*(const BasicPolynomial<F>& a, const SparsePolynomial<F>& b) {
+    if (a.degree() == -1 || b.degree() == -1) return BasicPolynomial<F>();
+    const size_t n = a.coeffs.size();
+    vector<F> coeffs(n + b.terms.back().first, F(0));
+    for (const auto& [e, c] : b.terms) {
+        kernels::axpy<F, F>(std::span<F>(coeffs).subspan(e, n), c, std::span<const F>(a.coeffs).first(n));
+    }
+    return BasicPolynomial<F>(coeffs);
+}
+
+template <class F>
+BasicPolynomial<F> operator*(const SparsePolynomial<F>& a, const BasicPolynomial<F>& b) {
+    return b * a;
+}
+
+// Long division by a sparse divisor in O(n * terms), in the layout of division::long_division:
+// each quotient coefficient only touches the positions of the divisor's terms
+template <class F>
+void divided_by(const BasicPolynomial<F>& a, const SparsePolynomial<F>& b, BasicPolynomial<F>& quotient, BasicPolynomial<F>& remainder) {
+    if (b.degree() == -1) {
+        throw std::invalid_argument("Divisor cannot be zero polynomial");
+    }
+    const size_t m = static_cast<size_t>(b.degree());
+    vector<F> r = a.coeffs;
+    if (r.size() <= m) {
+        quotient = BasicPolynomial<F>();
+        remainder = a;
+        return;
+    }
+    const F lc_inv = b.leading_coefficient().inv();
+    for (size_t k = r.size() - m; k-- != 0;) {
+        const F q = r[k + m] * lc_inv;
+        r[k + m] = q;
+        if (q == F(0)) continue;
+        for (size_t t = 0; t + 1 < b.terms.size(); t++) {
+            r[k + b.terms[t].first] = r[k + b.terms[t].first] - q * b.terms[t].second;
+        }
+    }
+    quotient = BasicPolynomial<F>(vector<F>(r.begin() + m, r.end()));
+    r.resize(m);
+    remainder = BasicPolynomial<F>(r);
+}
+
+template <class F>
+BasicPolynomial<F> operator/(const BasicPolynomial<F>& a, const SparsePolynomial<F>& b) {
+    BasicPolynomial<F> quotient, remainder;
+    divided_by(a, b, quotient, remainder);
+    if (remainder.degree() != -1) {
+        throw std::invalid_argument("Remainder is not zero");
+    }
+    return quotient;
+}
+
+template <class F>
+BasicPolynomial<F> operator%(const BasicPolynomial<F>& a, const SparsePolynomial<F>& b) {
+    BasicPolynomial<F> quotient, remainder;
+    divided_by(a, b, quotient, remainder);
+    return remainder;
+}
+
+/*
+    Zerofier of the subgroup of order n with a few points left out:
+
+        Z(x) = (x^n - 1) / prod_{p excluded} (x - p)
+
+    Described by n and the excluded points, evaluated anywhere off the subgroup in O(log n + k)
+    and on a whole coset of size N in O(N log N) whatever k is. The transition zerofier of a
+    trace whose last rows are unconstrained is of this shape.
+*/
+template <class F>
+class SubgroupZerofier {
+    public:
+        SubgroupZerofier(size_t n, const vector<F>& excluded_points)
+            : vanishing(SparsePolynomial<F>::subgroup_zerofier(n)), excluded(zerofier_domain(excluded_points)) {}
+
+        F operator[](const F& x) const {
+            return vanishing[x] / excluded[x];
+        }
+
+        // 1 / Z on a coset that does not meet the subgroup: the batch inversion only covers one
+        // period of x^n - 1, the excluded factor is extended onto the coset and multiplied back in
+        vector<F> inverse_codeword(const Domain<F>& domain) const {
+            vector<F> values = vanishing.evaluate_domain(domain);
+            const size_t period = domain.size() >> std::min<size_t>(__builtin_ctzll(vanishing.degree()), __builtin_ctzll(domain.size()));
+            vector<F> head(values.begin(), values.begin() + period);
+            batch_inverse(head);
+            for (size_t j = 0; j != values.size(); j++) values[j] = head[j % period];
+            kernels::mul(values, values, coset_lde(excluded, domain));
+            return values;
+        }
+
+        BasicPolynomial<F> dense() const {
+            return vanishing.dense() / excluded;
+        }
+
+    private:
+        SparsePolynomial<F> vanishing;
+        BasicPolynomial<F> excluded;
+};
+
+#endif
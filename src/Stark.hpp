@@ -6,8 +6,11 @@
 #include <cmath>
 #include "../src/MPolynomial.hpp"
 #include "../src/Polynomial.hpp"
+#include "../src/SparsePolynomial.hpp"
 #include "../src/Field.hpp"
 #include "../src/FRI.hpp"
+#include "../src/ExtField.hpp"
+#include "../src/Domain.hpp"
 #include "../src/merklecpp.h"
 
 using std::tuple;
@@ -19,7 +22,8 @@ using std::endl;
 
 namespace STARK {
     
-    vector<uint8_t> serialize_boundary_commitment(vector<vector<FieldElement> > &boundary_quotient_codewords) {
+    template <class F>
+    vector<uint8_t> serialize_boundary_commitment(vector<vector<F> > &boundary_quotient_codewords) {
         vector<uint8_t> serialized_boundary_commitment;
         for (auto &codeword : boundary_quotient_codewords) {
             merkle::Tree tree;
@@ -33,10 +37,11 @@ namespace STARK {
         return serialized_boundary_commitment;
     }   
 
+    template <class F>
     void prove(
-        vector<vector<FieldElement> > &trace_matrix,
-        vector<MPolynomial> &transition_constraints,
-        vector<tuple<size_t, size_t, FieldElement> > &boundary_constraints,
+        vector<vector<F> > &trace_matrix,
+        vector<BasicMPolynomial<F> > &transition_constraints,
+        vector<tuple<size_t, size_t, F> > &boundary_constraints,
         void (*commit)(void*),
         void (*get_challenge)(void*),
         vector<void(*)(void*)> &fri_fns,
@@ -44,45 +49,48 @@ namespace STARK {
         size_t expansion_factor=4,
         size_t num_randomizors=2
     ) {
-        size_t trace_length = trace_matrix.size() + num_randomizors;
+        // The trace domain is the whole subgroup <omicron>, so every register is interpolated with
+        // a single inverse NTT. The trace is padded up to a power of two with copies of its final
+        // row, which must satisfy the transition constraints into itself as a HALT row does, and
+        // then num_randomizors randomizer rows.
+        size_t trace_length = 1;
+        while (trace_length < trace_matrix.size() + num_randomizors) trace_length <<= 1;
         size_t register_count = trace_matrix[0].size();
         size_t omicron_domain_length = 1 << ((size_t)log2(trace_length * transition_constraints_degree));
         size_t fri_domain_length = omicron_domain_length * expansion_factor;
 
 
-        FieldElement g = generator();
-        FieldElement omega = primitive_nth_root(static_cast<ttmath::ulint>(fri_domain_length));
-        FieldElement omicron = primitive_nth_root(static_cast<ttmath::ulint>(omicron_domain_length));
+        F g = F::generator();
+        auto fri_coset = Domain<F>::get(g, fri_domain_length);
+        auto omicron_domain = Domain<F>::subgroup(trace_length);
 
+        const vector<F> final_row = trace_matrix.back();
+        while (trace_matrix.size() != trace_length - num_randomizors) trace_matrix.push_back(final_row);
         for (size_t i = 0; i != num_randomizors; i++) {
-            trace_matrix.push_back(vector<FieldElement>(register_count, FieldElement((i + 1) * 20)));
+            trace_matrix.push_back(vector<F>(register_count, F((i + 1) * 20)));
         }
 
-        vector<FieldElement> fri_domain(fri_domain_length);
-        for (size_t i = 0; i != fri_domain_length; i++) {
-            fri_domain[i] = (g * (omega^i));
-        }
 
-        vector<FieldElement> trace_domain(trace_length);
-        for (size_t i = 0; i != trace_length; i++) {
-            trace_domain[i] = omicron^(i);
+        // All registers are interpolated, and below extended, in one batched transform each
+        vector<vector<F> > trace_columns(register_count, vector<F>(trace_length));
+        for (size_t j = 0; j != trace_length; j++) {
+            for (size_t i = 0; i != register_count; i++) trace_columns[i][j] = trace_matrix[j][i];
         }
+        vector<BasicPolynomial<F> > trace_polynomials = interpolate_subgroup_columns(*omicron_domain, trace_columns);
 
-        vector<Polynomial> trace_polynomials;
-        for (size_t i = 0; i != register_count; i++) {
-            vector<FieldElement> single_reg_trace(trace_length);
-            for (size_t j = 0; j != trace_length; j++) single_reg_trace[j] = trace_matrix[j][i];
-            trace_polynomials.push_back(interpolate_domain(trace_domain, single_reg_trace));
-        }
+        // Every quotient is computed in evaluation form on the FRI coset, where no zerofier
+        // vanishes: numerator codeword times batch-inverted zerofier codeword
+        const vector<F>& coset = fri_coset->elements();
+        vector<vector<F> > trace_codewords = coset_lde_columns(trace_polynomials, *fri_coset);
 
-        vector<Polynomial> boundary_quotients(register_count);
+        vector<vector<F> > boundary_quotient_codewords(register_count, vector<F>(fri_domain_length, F(0)));
 
         // cout << "Boundary constraints: ";
         // for (auto &point : boundary_constraints) {
         //     cout << "(" << std::get<0>(point) << ", " << std::get<1>(point) << ", " << std::get<2>(point) << ") ";
         // }
         for (size_t i = 0; i != register_count; i++) {
-            vector<tuple<size_t, FieldElement> > single_reg_boundary_constraints;
+            vector<tuple<size_t, F> > single_reg_boundary_constraints;
             
             for (auto &point : boundary_constraints) {
                 if (std::get<1>(point) == i) {
@@ -94,61 +102,67 @@ namespace STARK {
             if (single_reg_boundary_constraints.size() == 0) {
                 continue;
             }
-            vector<FieldElement> single_reg_boundary_domain;
-            vector<FieldElement> single_reg_boundary_values;
+            vector<F> single_reg_boundary_domain;
+            vector<F> single_reg_boundary_values;
             for (auto &point : single_reg_boundary_constraints) {
-                single_reg_boundary_domain.push_back(omicron^(std::get<0>(point)));
+                single_reg_boundary_domain.push_back((*omicron_domain)[std::get<0>(point)]);
                 single_reg_boundary_values.push_back(std::get<1>(point));
             }
 
-            Polynomial zerofier = zerofier_domain(single_reg_boundary_domain);
-            Polynomial boundary_constraints_interpolant = interpolate_domain(single_reg_boundary_domain, single_reg_boundary_values);
-            boundary_quotients[i] = (trace_polynomials[i] - boundary_constraints_interpolant) / zerofier;
+            BasicPolynomial<F> zerofier = zerofier_domain(single_reg_boundary_domain);
+            BasicPolynomial<F> boundary_constraints_interpolant = interpolate_domain(single_reg_boundary_domain, single_reg_boundary_values);
+            vector<F> zerofier_inverses = zerofier.evaluate_domain(coset);
+            batch_inverse(zerofier_inverses);
+            vector<F>& quotient = boundary_quotient_codewords[i];
+            kernels::sub(quotient, trace_codewords[i], boundary_constraints_interpolant.evaluate_domain(coset));
+            kernels::mul(quotient, quotient, zerofier_inverses);
         }
 
-        vector<vector<FieldElement> > boundary_quotient_codewords(register_count);
+        // Pointwise values of the symbolic arguments x, T_i(x) and the next row T_i(omicron x).
+        // omicron is generator^(fri_domain_length / trace_length) of the coset's subgroup, so
+        // T_i(omicron x) is the codeword of T_i rotated by that many positions
+        const size_t next_row_shift = fri_domain_length / trace_length;
+        vector<vector<F> > transition_arguments(2 * register_count + 1);
+        transition_arguments[0] = coset;
         for (size_t i = 0; i != register_count; i++) {
-            boundary_quotient_codewords[i] = boundary_quotients[i].evaluate_domain(fri_domain);
+            transition_arguments[i + 1] = trace_codewords[i];
+            transition_arguments[register_count + 1 + i].resize(fri_domain_length);
+            std::rotate_copy(trace_codewords[i].begin(), trace_codewords[i].begin() + next_row_shift, trace_codewords[i].end(),
+                             transition_arguments[register_count + 1 + i].begin());
         }
 
-
-        vector<Polynomial> transition_arguments(2 * register_count + 1);
-        transition_arguments[0] = Polynomial(vector<FieldElement>{FieldElement(0), FieldElement(1)});
-        for (size_t i = 0; i != register_count; i++) {
-            transition_arguments[i + 1] = trace_polynomials[i];
-            transition_arguments[register_count + 1 + i] = trace_polynomials[i].scale(omicron);
+        // The transition zerofier is (x^trace_length - 1) / prod (x - omicron^k) over the last
+        // num_randomizors + 1 rows, whose successors are randomizers or wrap around to row 0 and
+        // so are not subject to the constraints; the copies of the final row stay constrained
+        vector<F> excluded_rows;
+        for (size_t k = trace_length - num_randomizors - 1; k != trace_length; k++) {
+            excluded_rows.push_back((*omicron_domain)[k]);
         }
+        SubgroupZerofier<F> transition_zerofier(trace_length, excluded_rows);
+        vector<F> zerofier_inverses = transition_zerofier.inverse_codeword(*fri_coset);
 
-        vector<Polynomial> transition_quotient(transition_constraints.size());
-        vector<FieldElement> temp; // Because the last cycle is not subject to the constraint
-        for (size_t i = 0; i != num_randomizors + 1; i++) {
-            temp.push_back(trace_domain.back());
-            trace_domain.pop_back();
-        }
-        Polynomial transition_constraint_zerofier = zerofier_domain(trace_domain);
-        for (size_t i = 0; i != num_randomizors + 1; i++) {
-            trace_domain.push_back(temp[temp.size() - 1 - i]);
-        }
+        vector<vector<F> > quotient_codewords(transition_constraints.size());
         for (size_t i = 0; i != transition_constraints.size(); i++) {
-            Polynomial transition_ploynomial = transition_constraints[i].evaluate_symbolic(transition_arguments);
-            transition_quotient[i] = transition_ploynomial / transition_constraint_zerofier;
+            quotient_codewords[i] = transition_constraints[i].evaluate_codewords(transition_arguments);
+            kernels::mul(quotient_codewords[i], quotient_codewords[i], zerofier_inverses);
         }
 
         // vector<uint8_t> boundary_committment = serialize_boundary_commitment(boundary_quotient_codewords);
         commit((void*)&boundary_quotient_codewords);
         
-        vector<FieldElement> challenge(transition_quotient.size() + boundary_quotients.size());
+        // Challenges come from the extension when F is too small; the quotient codewords stay
+        // over F and are combined with mixed E x F products
+        using E = ChallengeField<F>;
+        vector<E> challenge(transition_constraints.size() + register_count);
         get_challenge((void*)&challenge);
 
-        Polynomial combined_constraints = Polynomial(vector<FieldElement>{FieldElement(0)});
-        for (size_t i = 0; i != transition_quotient.size(); i++) {
-            combined_constraints = combined_constraints + (transition_quotient[i] * Polynomial(vector<FieldElement>({challenge[i]})));
-        }
+        vector<E> combined_codeword(fri_domain_length);
+        vector<E> weights(challenge.begin(), challenge.begin() + transition_constraints.size());
+        kernels::linear_combination(combined_codeword, weights, quotient_codewords);
 
-        FRI::prove(
-            combined_constraints.evaluate_domain(fri_domain),
-            omega,
-            g,
+        FRI::prove<F, E>(
+            combined_codeword,
+            fri_coset,
             fri_fns[0],
             fri_fns[1],
             fri_fns[2],
@@ -80,18 +80,20 @@ namespace WITNESS {
     }
     
 
+    template <class F = FieldElement>
     void stark_challenge(void *data) {
-        vector<FieldElement> *challenge = static_cast<vector<FieldElement> *>(data);
+        vector<F> *challenge = static_cast<vector<F> *>(data);
         transcript += "Stark ask for " + std::to_string(challenge->size()) + " field elements\n";
         for (size_t i = 0; i < challenge->size(); i++) {
             string hash = sha256_decimal(transcript);
-            challenge->at(i) = FieldElement(hash);
+            challenge->at(i) = F(hash);
             transcript += "Challenge " + std::to_string(i) + ": " + (string)challenge->at(i) + "\n";
         }
     }
 
+    template <class F = FieldElement>
     void stark_commit(void *data) {
-        vector<vector<FieldElement> > boundary_quotient_codewords = *static_cast<vector<vector<FieldElement> > *>(data);
+        vector<vector<F> > boundary_quotient_codewords = *static_cast<vector<vector<F> > *>(data);
         transcript += "commit boundary quotient codewords: ";
         for (const auto &codeword : boundary_quotient_codewords) {
             transcript += "[ ";
@@ -103,8 +105,9 @@ namespace WITNESS {
         transcript += "\n";
     }
 
+    template <class F = FieldElement>
     void fri_commit(void *data) {
-        vector<FieldElement> *codewords = static_cast<vector<FieldElement> *>(data);
+        vector<F> *codewords = static_cast<vector<F> *>(data);
         fri_length = 0;
         transcript += "FRI commit round " + std::to_string(fri_commit_round) + ": ";
         for (const auto &codeword : *codewords) {
@@ -115,11 +118,12 @@ namespace WITNESS {
         fri_commit_round++;
     }
 
+    template <class F = FieldElement>
     void fri_getchallenge(void *data) {
-        FieldElement *challenge = static_cast<FieldElement *>(data);
+        F *challenge = static_cast<F *>(data);
         string hash = sha256_decimal(transcript);
         transcript += "FRI get challenge, response: " + hash + "\n";
-        *challenge = FieldElement(hash);
+        *challenge = F(hash);
     }
 
     void fri_getcolinearity_challenge(void *data) {
@@ -135,11 +139,12 @@ namespace WITNESS {
         return;
     }
 
+    template <class F = FieldElement>
     void fri_open_merkle(void *data) {
-        vector<FieldElement> codewords = *static_cast<vector<FieldElement> *>(data);
+        vector<F> codewords = *static_cast<vector<F> *>(data);
         transcript += "FRI open merkle: ";
-        vector<FieldElement> open_points_x = {codewords[0], codewords[1], codewords[2]};
-        vector<FieldElement> open_points_y = {codewords[3], codewords[4], codewords[5]};
+        vector<F> open_points_x = {codewords[0], codewords[1], codewords[2]};
+        vector<F> open_points_y = {codewords[3], codewords[4], codewords[5]};
 
         transcript += "open points: ";
         for (size_t i = 0; i != open_points_x.size(); i++) {
@@ -155,94 +160,120 @@ namespace WITNESS {
         }
     }
 
-    Polynomial lagrange_selector(const FieldElement &k, vector<FieldElement> &space) {
+    template <class F = FieldElement>
+    BasicPolynomial<F> lagrange_selector(const F &k, vector<F> &space) {
         if (find(space.begin(), space.end(), k) == space.end()) {
             throw std::invalid_argument("k is not in the space");
         }
     
-        Polynomial numerator(vector<FieldElement>({FieldElement(1)}));
-        Polynomial denominator(vector<FieldElement>({FieldElement(1)}));
-        Polynomial x(vector<FieldElement>({FieldElement(0), FieldElement(1)}));
+        BasicPolynomial<F> numerator(vector<F>({F(1)}));
+        F denominator(1);
+        BasicPolynomial<F> x(vector<F>({F(0), F(1)}));
     
         for (auto &point : space) {
             if (point == k) continue;
             numerator = numerator * (x - point);
             denominator = denominator * (k - point);
         }
-        Polynomial result = numerator / denominator;
+        BasicPolynomial<F> result = numerator.scale(denominator.inv());
         return result;
     }
 
-    vector<MPolynomial> AIR_transition_constraints() {
+    // All Lagrange selectors over `space` at once, sharing a single inversion
+    template <class F = FieldElement>
+    vector<BasicPolynomial<F> > lagrange_selectors(const vector<F> &space) {
+        BasicPolynomial<F> x(vector<F>({F(0), F(1)}));
+        vector<F> denominators(space.size(), F(1));
+        for (size_t i = 0; i != space.size(); i++) {
+            for (size_t j = 0; j != space.size(); j++) {
+                if (j == i) continue;
+                denominators[i] = denominators[i] * (space[i] - space[j]);
+            }
+        }
+        batch_inverse(denominators);
+
+        vector<BasicPolynomial<F> > selectors(space.size());
+        for (size_t i = 0; i != space.size(); i++) {
+            BasicPolynomial<F> numerator(vector<F>({denominators[i]}));
+            for (size_t j = 0; j != space.size(); j++) {
+                if (j == i) continue;
+                numerator *= x - space[j];
+            }
+            selectors[i] = numerator;
+        }
+        return selectors;
+    }
+
+    template <class F = FieldElement>
+    vector<BasicMPolynomial<F> > AIR_transition_constraints() {
         size_t trace_width = 12;
         size_t reg_count = 5;
-        vector<MPolynomial> constraints;
-        vector<MPolynomial> regs = identity(2 * trace_width + 1);
+        vector<BasicMPolynomial<F> > constraints;
+        vector<BasicMPolynomial<F> > regs = identity<F>(2 * trace_width + 1);
     
-        MPolynomial cycle = regs[0];
+        BasicMPolynomial<F> cycle = regs[0];
         auto [R0, R1, R2, R3, R4, OPCODE, RD, SR1, immFlg, Imm, PC, MEM] = std::tuple{regs[1], regs[2], regs[3], regs[4], regs[5], regs[6], regs[7], regs[8], regs[9], regs[10], regs[11], regs[12]};
         auto [R0n, R1n, R2n, R3n, R4n, OPCODEn, RDn, SR1n, immFlg_n, Imm_n, PCn, MEMn] = std::tuple{regs[13], regs[14], regs[15], regs[16], regs[17], regs[18], regs[19], regs[20], regs[21], regs[22], regs[23], regs[24]};
     
-        vector<MPolynomial> this_cycle = {R0, R1, R2, R3, R4, OPCODE, RD, SR1, immFlg, Imm, PC, MEM};
-        vector<MPolynomial> next_cycle = {R0n, R1n, R2n, R3n, R4n, OPCODEn, RDn, SR1n, immFlg_n, Imm_n, PCn, MEMn};
+        vector<BasicMPolynomial<F> > this_cycle = {R0, R1, R2, R3, R4, OPCODE, RD, SR1, immFlg, Imm, PC, MEM};
+        vector<BasicMPolynomial<F> > next_cycle = {R0n, R1n, R2n, R3n, R4n, OPCODEn, RDn, SR1n, immFlg_n, Imm_n, PCn, MEMn};
     
-        vector<FieldElement> reg_space(reg_count);
-        for (size_t i = 0; i != reg_count; i++) reg_space[i] = FieldElement(i);
+        vector<F> reg_space(reg_count);
+        for (size_t i = 0; i != reg_count; i++) reg_space[i] = F(i);
     
-        vector<FieldElement> instr_space(OP_COUNT); // 0 - HALT, 1 - ADD
-        for (size_t i = 0; i != instr_space.size(); i++) instr_space[i] = FieldElement(i);
+        vector<F> instr_space(OP_COUNT); // 0 - HALT, 1 - ADD
+        for (size_t i = 0; i != instr_space.size(); i++) instr_space[i] = F(i);
     
-        vector<Polynomial> reg_selector(reg_count);
-        for (size_t i = 0; i != reg_count; i++) reg_selector[i] = lagrange_selector(i, reg_space);
+        vector<BasicPolynomial<F> > reg_selector = lagrange_selectors(reg_space);
     
-        vector<Polynomial> instr_selector(instr_space.size());
-        for (size_t i = 0; i != instr_space.size(); i++) instr_selector[i] = lagrange_selector(i, instr_space);
+        vector<BasicPolynomial<F> > instr_selector = lagrange_selectors(instr_space);
     
-        MPolynomial dst_reg = MPolynomial();
-        MPolynomial src_reg = MPolynomial();
-        MPolynomial src_reg1 = MPolynomial();
-        MPolynomial src_reg2 = MPolynomial();
+        BasicMPolynomial<F> dst_reg = BasicMPolynomial<F>();
+        BasicMPolynomial<F> src_reg = BasicMPolynomial<F>();
+        BasicMPolynomial<F> src_reg1 = BasicMPolynomial<F>();
+        BasicMPolynomial<F> src_reg2 = BasicMPolynomial<F>();
     
         for (size_t i = 0; i != reg_count; i++) {
-            dst_reg = dst_reg + (MPolynomial(reg_selector[i], R_RD) * next_cycle[i]);
+            dst_reg = dst_reg + (BasicMPolynomial<F>(reg_selector[i], R_RD) * next_cycle[i]);
         }
     
         for (size_t i = 0; i != reg_count; i++) {
-            src_reg = src_reg + (MPolynomial(reg_selector[i], R_RD) * this_cycle[i]);
+            src_reg = src_reg + (BasicMPolynomial<F>(reg_selector[i], R_RD) * this_cycle[i]);
         }
     
         for (size_t i = 0; i != reg_count; i++) {
-            src_reg1 = src_reg1 + (MPolynomial(reg_selector[i], R_SR1) * this_cycle[i]);
+            src_reg1 = src_reg1 + (BasicMPolynomial<F>(reg_selector[i], R_SR1) * this_cycle[i]);
         }
     
         for (size_t i = 0; i != reg_count; i++) {
-            src_reg2 = src_reg2 + (MPolynomial(reg_selector[i], R_IMM) * this_cycle[i]);
+            src_reg2 = src_reg2 + (BasicMPolynomial<F>(reg_selector[i], R_IMM) * this_cycle[i]);
         }
     
-        MPolynomial sel_ADD = MPolynomial(instr_selector[1], R_OPCODE) * this_cycle[R_OPCODE];
-        MPolynomial one = MPolynomial(1);
+        BasicMPolynomial<F> sel_ADD = BasicMPolynomial<F>(instr_selector[1], R_OPCODE) * this_cycle[R_OPCODE];
+        BasicMPolynomial<F> one = BasicMPolynomial<F>(1);
     
         // ADD semantics
         constraints.push_back(sel_ADD * immFlg * (dst_reg - src_reg1 - Imm));
         constraints.push_back(sel_ADD * (one - immFlg) * (dst_reg - src_reg1 - src_reg2));
     
         // LD semantics
-        MPolynomial sel_LD = MPolynomial(instr_selector[2], R_OPCODE) * this_cycle[R_OPCODE];
+        BasicMPolynomial<F> sel_LD = BasicMPolynomial<F>(instr_selector[2], R_OPCODE) * this_cycle[R_OPCODE];
         constraints.push_back(sel_LD * immFlg * (dst_reg - Imm));
         constraints.push_back(sel_LD * (one - immFlg) * (dst_reg - MEM));
     
         // ST semantics
-        MPolynomial sel_ST = MPolynomial(instr_selector[3], R_OPCODE) * this_cycle[R_OPCODE];
+        BasicMPolynomial<F> sel_ST = BasicMPolynomial<F>(instr_selector[3], R_OPCODE) * this_cycle[R_OPCODE];
         constraints.push_back(sel_ST * immFlg * (MEMn - Imm));
         constraints.push_back(sel_ST * (one - immFlg) * (MEMn - src_reg));
     
         return constraints;
     }
     
-    vector<tuple<size_t, size_t, FieldElement> > create_boundary_constraints(vector<vector<FieldElement> > &trace_matrix) 
+    template <class F = FieldElement>
+    vector<tuple<size_t, size_t, F> > create_boundary_constraints(vector<vector<F> > &trace_matrix) 
     // (cycle, register, value)
     {
-        vector<tuple<size_t, size_t, FieldElement> > results;
+        vector<tuple<size_t, size_t, F> > results;
         for (size_t i = 0; i != trace_matrix[0].size(); i++) {
             results.push_back(std::make_tuple(0, i, trace_matrix[0][i]));
         }
@@ -253,25 +284,27 @@ namespace WITNESS {
         return results;
     }
 
+    template <class F = FieldElement>
     string witness(
-        vector<vector<FieldElement> > &trace_matrix,
+        vector<vector<F> > &trace_matrix,
         size_t transition_constraints_degree=2,
         size_t expansion_factor=4,
         size_t num_randomizors=2
     ) {
         transcript = "STARK witness started\n";
-        vector<MPolynomial> transition_constraints = AIR_transition_constraints();
-        vector<tuple<size_t, size_t, FieldElement> > boundary_constraints = create_boundary_constraints(trace_matrix);
+        vector<BasicMPolynomial<F> > transition_constraints = AIR_transition_constraints<F>();
+        vector<tuple<size_t, size_t, F> > boundary_constraints = create_boundary_constraints(trace_matrix);
         fri_commit_round = 0;
         fri_length = 0;
         fri_pass = true;
-        vector<void (*) (void*)> fri_fns = {fri_commit, fri_getchallenge, fri_getcolinearity_challenge, fri_open_merkle};
+        using E = ChallengeField<F>;
+        vector<void (*) (void*)> fri_fns = {fri_commit<E>, fri_getchallenge<E>, fri_getcolinearity_challenge, fri_open_merkle<E>};
         STARK::prove(
             trace_matrix,
             transition_constraints,
             boundary_constraints,
-            stark_commit,
-            stark_challenge,
+            stark_commit<F>,
+            stark_challenge<E>,
             fri_fns,
             11,
             4,
@@ -0,0 +1,391 @@
+#include "../src/Field.hpp"
+#include "../src/ExtField.hpp"
+#include "../src/FieldKernels.hpp"
+#include "../src/NTT.hpp"
+#include "../src/Convolution.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+
+/*
+    Field arithmetic microbenchmarks.
+
+        bench_field [--json] [--out FILE] [--baseline FILE] [--threshold PCT] [--runs N] [--quick]
+
+    Every (field, operation, backend) row reports nanoseconds per element. The "ttmath" backend
+    is the BigInt reference the field used to be built on; the kernel rows run once per vector
+    backend the CPU supports. Every row also records reference_ns, a fixed ttmath workload timed
+    alongside it. With --baseline, rows whose time relative to their reference grew by more than
+    the threshold (default 25%) are re-timed, and if the median of their timings stays over the
+    exit status is 1. Baselines are only comparable on the machine that recorded
+    them; record one with --runs 7 so each row is the median of seven passes.
+*/
+
+using std::cout;
+using std::endl;
+using std::map;
+
+struct Result {
+    string field, op, backend;
+    double ns, reference_ns; // the row, and the reference workload timed alongside it
+
+    string key() const { return field + "," + op + "," + backend; }
+};
+
+using Selection = std::function<bool(const string &field, const string &op, const string &backend)>;
+
+template <class T>
+inline void keep(const T &x) {
+    asm volatile("" : : "r"(&x) : "memory");
+}
+
+double sample_seconds = 0.05;
+const size_t samples = 9;
+
+BigInt random_bigint(std::mt19937_64 &rng) {
+    BigInt r = 0;
+    for (size_t i = 0; i != 4; i++) r = (r << 32) + BigInt(static_cast<ttmath::uint>(rng() & 0xffffffff));
+    return r;
+}
+
+// A fixed workload the tree never changes, BigInt products modulo the P128 prime, whose time
+// measures how fast the machine is running at the moment
+struct Reference {
+    static constexpr size_t elements = 64;
+    const BigInt p = FieldElement::modulus();
+    vector<BigInt> a, b, out;
+
+    Reference() : a(elements), b(elements), out(elements) {
+        std::mt19937_64 rng(7);
+        for (size_t i = 0; i != elements; i++) {
+            a[i] = random_bigint(rng) % p;
+            b[i] = random_bigint(rng) % p;
+        }
+    }
+
+    void operator()() {
+        for (size_t i = 0; i != elements; i++) out[i] = (a[i] * b[i]) % p;
+        keep(out);
+    }
+};
+
+// Nanoseconds per element of fn, which processes `elements` elements per call, repeated for
+// sample_seconds. Each sample is paired with a shorter one of the reference workload taken right
+// after it, and the row reports the pair with the median ratio, so its relative time compares
+// readings from the same moment and one sample that caught interference, in either direction, does
+// not move it.
+Result time_ns(size_t elements, const std::function<void()> &fn) {
+    using clock = std::chrono::steady_clock;
+    static Reference reference;
+    auto sample = [](size_t elements, double seconds, const std::function<void()> &fn) {
+        size_t calls = 0;
+        auto start = clock::now();
+        double elapsed = 0;
+        do {
+            fn();
+            calls++;
+            elapsed = std::chrono::duration<double>(clock::now() - start).count();
+        } while (elapsed < seconds);
+        return elapsed * 1e9 / (double)(calls * elements);
+    };
+    fn(); // warm up tables and caches
+    vector<double> ns(samples), reference_ns(samples);
+    for (size_t s = 0; s != samples; s++) {
+        ns[s] = sample(elements, sample_seconds, fn);
+        reference_ns[s] = sample(Reference::elements, sample_seconds / 4, std::ref(reference));
+    }
+    vector<size_t> order(samples);
+    for (size_t s = 0; s != samples; s++) order[s] = s;
+    std::nth_element(order.begin(), order.begin() + samples / 2, order.end(),
+                     [&](size_t x, size_t y) { return ns[x] / reference_ns[x] < ns[y] / reference_ns[y]; });
+    const size_t median = order[samples / 2];
+    return {"", "", "", ns[median], reference_ns[median]};
+}
+
+// Products of two length-n polynomials through each tier of convolution::multiply, at lengths
+// around the crossovers; KARATSUBA_THRESHOLD and NTT_THRESHOLD are read off these rows
+template <class T>
+void bench_multiply(const string &name, std::mt19937_64 &rng, vector<Result> &results, const Selection &selected, std::initializer_list<size_t> lengths) {
+    auto row = [&](const string &op, const string &backend, size_t elements, const std::function<void()> &fn) {
+        if (!selected(name, op, backend)) return;
+        Result r = time_ns(elements, fn);
+        results.push_back({name, op, backend, r.ns, r.reference_ns});
+    };
+    for (size_t len : lengths) {
+        vector<T> a(len), b(len), out(2 * len - 1), scratch(convolution::karatsuba_scratch<T>(len));
+        for (size_t i = 0; i != len; i++) {
+            a[i] = T(random_bigint(rng));
+            b[i] = T(random_bigint(rng));
+        }
+        string op = "poly_mul_" + std::to_string(len);
+        row(op, "schoolbook", len, [&] { convolution::schoolbook<T>(a, b, out); keep(out); });
+        // At or below its threshold karatsuba() is the schoolbook product, which has its own row
+        if (len > convolution::KARATSUBA_THRESHOLD<T>) {
+            row(op, "karatsuba", len, [&] { convolution::karatsuba<T>(a, b, out, scratch); keep(out); });
+        }
+        row(op, "ntt", len, [&] { convolution::ntt<T>(a, b, out); keep(out); });
+    }
+}
+
+// x^-1 mod p by the extended Euclidean algorithm, as the BigInt field inverted
+BigInt bigint_inverse(const BigInt &x, const BigInt &p) {
+    BigInt old_r = x, r = p, old_s = 1, s = 0;
+    while (r != 0) {
+        BigInt q = old_r / r, t = r;
+        r = old_r - q * r;
+        old_r = t;
+        t = s;
+        s = old_s - q * s;
+        old_s = t;
+    }
+    return (old_s % p + p) % p;
+}
+
+// x^e mod p by square-and-multiply over BigInt, as the BigInt field exponentiated
+BigInt bigint_pow(BigInt x, BigInt e, const BigInt &p) {
+    BigInt result = 1;
+    while (e != 0) {
+        if (e % 2 == 1) result = result * x % p;
+        x = x * x % p;
+        e = e >> 1;
+    }
+    return result;
+}
+
+template <class F>
+void bench(const string &name, std::mt19937_64 &rng, vector<Result> &results, const Selection &selected) {
+    const size_t n = 4096;
+    vector<F> a(n), b(n), out(n);
+    for (size_t i = 0; i != n; i++) {
+        a[i] = F(random_bigint(rng));
+        b[i] = F(random_bigint(rng));
+        if (b[i] == F(0)) b[i] = F(1);
+    }
+    // fn processes `elements` elements per call; it is only timed if the row is selected
+    auto row = [&](const string &op, const string &backend, size_t elements, const std::function<void()> &fn) {
+        if (!selected(name, op, backend)) return;
+        Result r = time_ns(elements, fn);
+        results.push_back({name, op, backend, r.ns, r.reference_ns});
+    };
+
+    row("add", "scalar", n, [&] { for (size_t i = 0; i != n; i++) out[i] = a[i] + b[i]; keep(out); });
+    row("mul", "scalar", n, [&] { for (size_t i = 0; i != n; i++) out[i] = a[i] * b[i]; keep(out); });
+    row("inv", "scalar", 64, [&] { for (size_t i = 0; i != 64; i++) out[i] = b[i].inv(); keep(out); });
+    row("batch_inverse", "scalar", n, [&] { out = b; batch_inverse(out); keep(out); });
+    row("pow", "scalar", 64, [&] { for (size_t i = 0; i != 64; i++) out[i] = a[i] ^ 0xfedcba9876543210ULL; keep(out); });
+
+    vector<uint8_t> bytes(n * F::num_bytes);
+    row("encode", "scalar", n, [&] { for (size_t i = 0; i != n; i++) a[i].to_bytes(&bytes[i * F::num_bytes]); keep(bytes); });
+    row("decode", "scalar", n, [&] { for (size_t i = 0; i != n; i++) out[i] = F::from_bytes(&bytes[i * F::num_bytes]); keep(out); });
+
+    vector<uint32_t> small(n);
+    for (size_t i = 0; i != n; i++) small[i] = (uint32_t)rng();
+    row("from_u32", "scalar", n, [&] { from_u32<F>(small, out); keep(out); });
+
+    kernels::Backend best = kernels::detect_backend();
+    for (auto backend : {kernels::Backend::Scalar, kernels::Backend::AVX2, kernels::Backend::AVX512}) {
+        if (static_cast<int>(backend) > static_cast<int>(best)) break;
+        kernels::set_backend(backend);
+        string tag = string("kernel_") + kernels::backend_name(backend);
+        row("add", tag, n, [&] { kernels::add(out, a, b); keep(out); });
+        row("sub", tag, n, [&] { kernels::sub(out, a, b); keep(out); });
+        row("mul", tag, n, [&] { kernels::mul(out, a, b); keep(out); });
+        row("axpy", tag, n, [&] { kernels::axpy(out, a[0], b); keep(out); });
+    }
+    kernels::set_backend(best);
+
+    row("dot", "scalar", n, [&] {
+        F sum = F(0);
+        for (size_t i = 0; i != n; i++) sum = sum + a[i] * b[i];
+        out[0] = sum;
+        keep(out);
+    });
+    row("dot", "lazy", n, [&] {
+        Accumulator<F> acc;
+        for (size_t i = 0; i != n; i++) acc.add_product(a[i], b[i]);
+        out[0] = acc.reduce();
+        keep(out);
+    });
+
+    // Both NTT paths, called directly whatever FOUR_STEP_THRESHOLD<F> is, at a size that fits in
+    // cache and at 2^22; the threshold belongs where four_step starts winning
+    for (size_t log_size : {18, 22}) {
+        const size_t size = (size_t)1 << log_size;
+        vector<F> values(size);
+        for (size_t i = 0; i != size; i++) values[i] = a[i % n] + b[i / n % n];
+        string op = "ntt_2^" + std::to_string(log_size);
+        row(op, "radix2", size, [&] { NTT::forward<F, F>(std::span<F>(values), NTT::split_stages(size)); keep(values); });
+        row(op, "four_step", size, [&] { NTT::four_step<F, F, false>(std::span<F>(values)); keep(values); });
+    }
+
+    bench_multiply<F>(name, rng, results, selected, {16, 32, 64, 128, 256, 512});
+    if constexpr (F::params::ext_degree > 1) bench_multiply<ChallengeField<F> >(name + "_ext", rng, results, selected, {4, 8, 16, 32, 64, 128});
+
+    // The BigInt path every operation used before the Montgomery representation
+    const BigInt p = F::modulus();
+    const size_t m = 256;
+    vector<BigInt> ba(m), bb(m), bout(m);
+    for (size_t i = 0; i != m; i++) {
+        ba[i] = a[i].to_bigint();
+        bb[i] = b[i].to_bigint();
+    }
+    row("add", "ttmath", m, [&] { for (size_t i = 0; i != m; i++) bout[i] = (ba[i] + bb[i]) % p; keep(bout); });
+    row("mul", "ttmath", m, [&] { for (size_t i = 0; i != m; i++) bout[i] = (ba[i] * bb[i]) % p; keep(bout); });
+    row("inv", "ttmath", 64, [&] { for (size_t i = 0; i != 64; i++) bout[i] = bigint_inverse(bb[i], p); keep(bout); });
+    row("batch_inverse", "ttmath", m, [&] { for (size_t i = 0; i != m; i++) bout[i] = bigint_inverse(bb[i], p); keep(bout); });
+    const BigInt exponent = BigInt("18364758544493064720"); // 0xfedcba9876543210, as in the scalar row
+    row("pow", "ttmath", 64, [&] { for (size_t i = 0; i != 64; i++) bout[i] = bigint_pow(ba[i], exponent, p); keep(bout); });
+    vector<string> strings(m);
+    row("encode", "ttmath", m, [&] { for (size_t i = 0; i != m; i++) strings[i] = ba[i].ToString(10); keep(strings); });
+    row("decode", "ttmath", m, [&] { for (size_t i = 0; i != m; i++) bout[i] = BigInt(strings[i]); keep(bout); });
+}
+
+map<string, Result> read_baseline(const string &path) {
+    map<string, Result> baseline;
+    std::ifstream in(path);
+    string line;
+    std::getline(in, line); // header
+    while (std::getline(in, line)) {
+        std::istringstream ss(line);
+        string field, op, backend, ns, reference_ns;
+        if (!std::getline(ss, field, ',') || !std::getline(ss, op, ',') || !std::getline(ss, backend, ',') || !std::getline(ss, ns, ',')) continue;
+        Result r = {field, op, backend, std::stod(ns), 0};
+        if (std::getline(ss, reference_ns)) r.reference_ns = std::stod(reference_ns);
+        baseline[r.key()] = r;
+    }
+    return baseline;
+}
+
+string to_csv(const vector<Result> &results) {
+    std::ostringstream os;
+    os << "field,op,backend,ns_per_element,reference_ns\n";
+    for (const auto &r : results) os << r.field << "," << r.op << "," << r.backend << "," << r.ns << "," << r.reference_ns << "\n";
+    return os.str();
+}
+
+string to_json(const vector<Result> &results) {
+    std::ostringstream os;
+    os << "[\n";
+    for (size_t i = 0; i != results.size(); i++) {
+        const auto &r = results[i];
+        os << "  {\"field\": \"" << r.field << "\", \"op\": \"" << r.op << "\", \"backend\": \"" << r.backend
+           << "\", \"ns_per_element\": " << r.ns << ", \"reference_ns\": " << r.reference_ns << "}" << (i + 1 == results.size() ? "\n" : ",\n");
+    }
+    os << "]\n";
+    return os.str();
+}
+
+vector<Result> run_all(const Selection &selected) {
+    std::mt19937_64 rng(42);
+    vector<Result> results;
+    bench<FieldElement>("p128", rng, results, selected);
+    bench<GoldilocksElement>("goldilocks", rng, results, selected);
+    bench<BabyBearElement>("babybear", rng, results, selected);
+    return results;
+}
+
+// A row's time in units of the reference workload timed alongside it, which divides out how fast
+// the machine happened to be running
+double relative(const Result &r) {
+    return r.reference_ns > 0 ? r.ns / r.reference_ns : r.ns;
+}
+
+// Percent change of a row's relative time against the baseline; rows recorded without a
+// reference compare nanoseconds
+double change(const Result &r, const Result &base) {
+    if (r.reference_ns > 0 && base.reference_ns > 0) return (relative(r) / relative(base) - 1) * 100;
+    return (r.ns / base.ns - 1) * 100;
+}
+
+// The timing of a row with the median relative time
+Result median(vector<Result> timings) {
+    std::nth_element(timings.begin(), timings.begin() + timings.size() / 2, timings.end(),
+                     [](const Result &x, const Result &y) { return relative(x) < relative(y); });
+    return timings[timings.size() / 2];
+}
+
+int main(int argc, char **argv) {
+    bool json = false;
+    string out_path, baseline_path;
+    double threshold = 25;
+    size_t runs = 1;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--json") json = true;
+        else if (arg == "--quick") sample_seconds = 0.001;
+        else if (arg == "--out" && i + 1 < argc) out_path = argv[++i];
+        else if (arg == "--baseline" && i + 1 < argc) baseline_path = argv[++i];
+        else if (arg == "--threshold" && i + 1 < argc) threshold = std::stod(argv[++i]);
+        else if (arg == "--runs" && i + 1 < argc) runs = std::max(1, std::stoi(argv[++i]));
+        else {
+            std::cerr << "usage: " << argv[0] << " [--json] [--out FILE] [--baseline FILE] [--threshold PCT] [--runs N] [--quick]" << endl;
+            return 2;
+        }
+    }
+
+    // Each row reports the pass with its median relative time
+    auto everything = [](const string &, const string &, const string &) { return true; };
+    vector<vector<Result>> passes;
+    for (size_t run = 0; run != runs; run++) passes.push_back(run_all(everything));
+    vector<Result> results = passes[0];
+    for (size_t i = 0; i != results.size(); i++) {
+        vector<Result> row;
+        for (const auto &pass : passes) row.push_back(pass[i]);
+        results[i] = median(row);
+    }
+
+    vector<string> regressions;
+    if (!baseline_path.empty()) {
+        map<string, Result> baseline = read_baseline(baseline_path);
+        map<string, double> changed;
+        for (const auto &r : results) {
+            if (baseline.count(r.key())) changed[r.key()] = change(r, baseline[r.key()]);
+        }
+        // A row over the threshold is timed three more times, for up to three rounds, and judged by
+        // the median of all its timings, so a regression cannot hide behind one lucky re-run
+        map<string, vector<Result>> timings;
+        for (const auto &r : results) timings[r.key()].push_back(r);
+        for (size_t round = 0; round != 3; round++) {
+            std::set<string> flagged;
+            for (const auto &[key, pct] : changed) {
+                if (pct > threshold) flagged.insert(key);
+            }
+            if (flagged.empty()) break;
+            std::cerr << flagged.size() << " row(s) over the threshold, re-timing" << endl;
+            for (size_t again = 0; again != 3; again++) {
+                for (const auto &t : run_all([&](const string &field, const string &op, const string &backend) {
+                         return flagged.count(field + "," + op + "," + backend) != 0;
+                     })) {
+                    timings[t.key()].push_back(t);
+                }
+            }
+            for (auto &r : results) {
+                if (!flagged.count(r.key())) continue;
+                r = median(timings[r.key()]);
+                changed[r.key()] = change(r, baseline[r.key()]);
+            }
+        }
+        for (const auto &r : results) {
+            if (!changed.count(r.key()) || changed[r.key()] <= threshold) continue;
+            std::ostringstream os;
+            os << "REGRESSION " << r.field << " " << r.op << " " << r.backend << ": " << baseline[r.key()].ns
+               << " -> " << r.ns << " ns (+" << changed[r.key()] << "%)";
+            regressions.push_back(os.str());
+        }
+    }
+
+    string report = json ? to_json(results) : to_csv(results);
+    if (out_path.empty()) cout << report;
+    else std::ofstream(out_path) << report;
+
+    if (baseline_path.empty()) return 0;
+    for (const auto &line : regressions) std::cerr << line << endl;
+    std::cerr << regressions.size() << " regression(s) against " << baseline_path << endl;
+    return regressions.empty() ? 0 : 1;
+}
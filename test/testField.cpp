@@ -0,0 +1,249 @@
+#include "../src/Field.hpp"
+#include "../src/ExtField.hpp"
+#include "../src/FieldKernels.hpp"
+#include "../src/Domain.hpp"
+#include <iostream>
+#include <random>
+
+using std::cout;
+using std::endl;
+
+BigInt random_bigint(std::mt19937_64 &rng) {
+    BigInt r = 0;
+    for (size_t i = 0; i != 4; i++) {
+        r = (r << 32) + BigInt(static_cast<ttmath::uint>(rng() & 0xffffffff));
+    }
+    return r;
+}
+
+template <class F>
+bool test_against_bigint(std::mt19937_64 &rng) {
+    const BigInt p = F::modulus();
+    for (size_t it = 0; it != 1000; it++) {
+        BigInt a = random_bigint(rng);
+        BigInt b = random_bigint(rng);
+        if (it % 3 == 0) a = -a;
+        BigInt ra = (a % p + p) % p;
+        BigInt rb = (b % p + p) % p;
+
+        F x(a), y(b);
+        if (x.to_bigint() != ra) return false;
+        if ((x + y).to_bigint() != (ra + rb) % p) return false;
+        if ((x - y).to_bigint() != (ra - rb + p) % p) return false;
+        if ((x * y).to_bigint() != ra * rb % p) return false;
+        if ((-x).to_bigint() != (p - ra) % p) return false;
+        if (y != F(0) && (x / y) * y != x) return false;
+        if (x != F(0) && (x ^ -b) * (x ^ b) != F(1)) return false;
+    }
+    return true;
+}
+
+template <class F>
+bool test_batch_inverse(std::mt19937_64 &rng) {
+    vector<F> xs;
+    for (size_t i = 0; i != 100; i++) {
+        xs.push_back(i % 17 == 0 ? F(0) : F(random_bigint(rng)));
+    }
+    vector<F> inverted = xs;
+    batch_inverse(inverted);
+    for (size_t i = 0; i != xs.size(); i++) {
+        if (xs[i] == F(0)) {
+            if (inverted[i] != F(0)) return false;
+        } else if (xs[i] * inverted[i] != F(1)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class F>
+bool test_roots_of_unity() {
+    F omega = F::primitive_nth_root(1024);
+    F top = F::primitive_nth_root(1ULL << std::min<size_t>(F::params::two_adicity, 63));
+    return (omega^1024ULL) == F(1) && (omega^512ULL) == -F(1) && (top^2ULL) != F(1);
+}
+
+template <class F>
+bool test_domain() {
+    F offset = F::generator();
+    auto domain = Domain<F>::get(offset, 64);
+    if (Domain<F>::get(offset, 64) != domain) return false; // cached
+    if (domain->generator() != F::primitive_nth_root(64)) return false;
+    for (size_t i = 0; i != 64; i++) {
+        if ((*domain)[i] != offset * (domain->generator()^(unsigned long long)i)) return false;
+        if (domain->inverses()[i] * (*domain)[i] != F(1)) return false;
+    }
+    auto squared = domain->square();
+    return squared->size() == 32 && (*squared)[5] == (*domain)[5] * (*domain)[5];
+}
+
+template <class F>
+bool test_extension(std::mt19937_64 &rng) {
+    using E = ExtFieldElement<F>;
+    constexpr size_t D = E::degree;
+    for (size_t it = 0; it != 100; it++) {
+        std::array<F, D> a, b;
+        for (size_t i = 0; i != D; i++) {
+            a[i] = F(random_bigint(rng));
+            b[i] = F(random_bigint(rng));
+        }
+        // schoolbook product reduced by x^D = W
+        vector<F> c(2 * D - 1, F(0));
+        for (size_t i = 0; i != D; i++) {
+            for (size_t j = 0; j != D; j++) c[i + j] = c[i + j] + a[i] * b[j];
+        }
+        std::array<F, D> expected;
+        for (size_t i = 0; i != D; i++) {
+            expected[i] = i + D < c.size() ? c[i] + E::nonresidue() * c[i + D] : c[i];
+        }
+        E x(a), y(b);
+        if ((x * y).coeffs != expected) return false;
+        if (x * x.inv() != E(F(1))) return false;
+        if (x.frobenius() != (x ^ (unsigned long long)F::params::modulus[0])) return false;
+        if (x * F(3) != x * E(F(3))) return false;
+        // negative constants embed like their base-field images
+        BigInt v = -(random_bigint(rng) % F::modulus());
+        if (E(v) != E(F(v)) || E(BigInt(-5)) != E(F(BigInt(-5)))) return false;
+    }
+    return true;
+}
+
+template <class F>
+bool test_small(std::mt19937_64 &rng) {
+    vector<uint32_t> words = {0, 1, 0xff, 0x100, 0xffff, 0x10000, 0x78000001, 0xffffffff};
+    for (size_t i = 0; i != 100; i++) words.push_back((uint32_t)rng());
+    vector<uint16_t> halves(words.size());
+    for (size_t i = 0; i != words.size(); i++) halves[i] = (uint16_t)words[i];
+    vector<F> from_words(words.size()), from_halves(halves.size());
+    from_u32<F>(words, from_words);
+    from_u16<F>(halves, from_halves);
+    for (size_t i = 0; i != words.size(); i++) {
+        if (from_words[i] != F(BigInt(static_cast<ttmath::uint>(words[i])))) return false;
+        if (from_halves[i] != F(BigInt(static_cast<ttmath::uint>(halves[i])))) return false;
+        if (F((size_t)words[i]) != from_words[i]) return false;
+    }
+    return true;
+}
+
+template <class F>
+bool test_bytes(std::mt19937_64 &rng) {
+    using E = ChallengeField<F>;
+    for (size_t it = 0; it != 100; it++) {
+        F x = it == 0 ? -F(1) : F(random_bigint(rng));
+        typename F::bytes_t bytes = x.to_bytes();
+        if (F::from_bytes(bytes) != x) return false;
+        // little-endian canonical value
+        BigInt v = 0;
+        for (size_t i = bytes.size(); i-- > 0;) v = (v << 8) + BigInt(static_cast<ttmath::uint>(bytes[i]));
+        if (v != x.to_bigint()) return false;
+        E e = E(random_bigint(rng));
+        if (E::from_bytes(e.to_bytes()) != e) return false;
+    }
+    typename F::bytes_t bytes = {};
+    for (size_t i = 0; i != bytes.size(); i++) bytes[i] = 0xff; // >= p in every field
+    try {
+        F::from_bytes(bytes);
+        return false;
+    } catch (const std::invalid_argument&) {}
+    return hash_from_FieldElement(F(7)) == hash_from_FieldElement(F(7)) && hash_from_FieldElement(F(7)) != hash_from_FieldElement(F(8));
+}
+
+// Lazily reduced sums must match term-by-term reduction, including at p - 1
+template <class F>
+bool test_accumulator(std::mt19937_64 &rng) {
+    using E = ChallengeField<F>;
+    Accumulator<F> acc;
+    Accumulator<E> eacc;
+    F expected = F(0);
+    E eexpected = E(0);
+    for (size_t i = 0; i != 1000; i++) {
+        F a = i % 4 == 0 ? -F(1) : F(random_bigint(rng));
+        F b = i % 3 == 0 ? -F(1) : F(random_bigint(rng));
+        E e = E(random_bigint(rng));
+        acc.add_product(a, b);
+        acc.add(b);
+        expected = expected + a * b + b;
+        eacc.add_product(e, a);
+        eacc.add_product(e, E(b));
+        eacc.add(e);
+        eexpected = eexpected + e * a + e * E(b) + e;
+    }
+    return acc.reduce() == expected && eacc.reduce() == eexpected;
+}
+
+// Every backend the CPU supports must agree with the scalar operators, including the tails
+template <class F>
+bool test_kernels(std::mt19937_64 &rng) {
+    using E = ChallengeField<F>;
+    const size_t n = 37;
+    vector<F> a(n), b(n), c(n);
+    vector<E> ea(n), eb(n);
+    for (size_t i = 0; i != n; i++) {
+        a[i] = F(random_bigint(rng));
+        b[i] = i % 5 == 0 ? a[i] : F(random_bigint(rng));
+        c[i] = i % 7 == 0 ? -F(1) : F(random_bigint(rng));
+        ea[i] = E(random_bigint(rng));
+        eb[i] = E(random_bigint(rng));
+    }
+    F s = F(random_bigint(rng));
+    E es = E(random_bigint(rng));
+
+    bool ok = true;
+    kernels::Backend best = kernels::detect_backend();
+    for (auto backend : {kernels::Backend::Scalar, kernels::Backend::AVX2, kernels::Backend::AVX512}) {
+        if (static_cast<int>(backend) > static_cast<int>(best)) break;
+        kernels::set_backend(backend);
+        vector<F> out(n);
+        vector<E> eout(n);
+        kernels::add(out, a, b);
+        for (size_t i = 0; i != n; i++) ok &= out[i] == a[i] + b[i];
+        kernels::sub(out, a, b);
+        for (size_t i = 0; i != n; i++) ok &= out[i] == a[i] - b[i];
+        kernels::mul(out, a, b);
+        for (size_t i = 0; i != n; i++) ok &= out[i] == a[i] * b[i];
+        kernels::scalar_mul(out, a, s);
+        for (size_t i = 0; i != n; i++) ok &= out[i] == a[i] * s;
+        kernels::fma(out, a, b, c);
+        for (size_t i = 0; i != n; i++) ok &= out[i] == a[i] * b[i] + c[i];
+        out = c;
+        kernels::axpy(out, s, a);
+        for (size_t i = 0; i != n; i++) ok &= out[i] == c[i] + s * a[i];
+
+        kernels::add(eout, ea, eb);
+        for (size_t i = 0; i != n; i++) ok &= eout[i] == ea[i] + eb[i];
+        kernels::sub(eout, ea, eb);
+        for (size_t i = 0; i != n; i++) ok &= eout[i] == ea[i] - eb[i];
+        kernels::scalar_mul(eout, ea, s);
+        for (size_t i = 0; i != n; i++) ok &= eout[i] == ea[i] * s;
+        eout = ea;
+        kernels::axpy(eout, es, a);
+        for (size_t i = 0; i != n; i++) ok &= eout[i] == ea[i] + es * a[i];
+    }
+    kernels::set_backend(best);
+    return ok;
+}
+
+template <class F>
+void run(const string &name, std::mt19937_64 &rng) {
+    cout << name << endl;
+    cout << "  Arithmetic against BigInt: " << (test_against_bigint<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Batch inverse: " << (test_batch_inverse<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Roots of unity: " << (test_roots_of_unity<F>() ? "pass" : "fail") << endl;
+    cout << "  Cached domains: " << (test_domain<F>() ? "pass" : "fail") << endl;
+    cout << "  Small integers: " << (test_small<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Byte encoding: " << (test_bytes<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Lazy accumulator: " << (test_accumulator<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Vector kernels: " << (test_kernels<F>(rng) ? "pass" : "fail") << endl;
+    if constexpr (F::params::ext_degree > 1) {
+        cout << "  Degree " << F::params::ext_degree << " extension: " << (test_extension<F>(rng) ? "pass" : "fail") << endl;
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(42);
+    cout << "Kernel backend: " << kernels::backend_name(kernels::active_backend()) << endl;
+
+    run<FieldElement>("p = 1 + 407 * 2^119", rng);
+    run<GoldilocksElement>("Goldilocks", rng);
+    run<BabyBearElement>("BabyBear", rng);
+}
@@ -16,13 +16,6 @@ using std::cout;
 using std::endl;
 
 
-merkle::Hash hash_from_FieldElement(const FieldElement& fe) {
-    string rep = (string)fe;
-    merkle::Hash h;
-    SHA256(reinterpret_cast<const uint8_t*>(rep.data()), rep.size(), h.bytes);
-    return h;
-}
-
 vector<FieldElement> from_vector(const vector<int>& vec) {
     vector<FieldElement> res;
     for (size_t i = 0; i != vec.size(); i++) {
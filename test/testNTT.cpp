@@ -0,0 +1,385 @@
+#include "../src/NTT.hpp"
+#include "../src/Polynomial.hpp"
+#include "../src/SparsePolynomial.hpp"
+#include "../src/ExtField.hpp"
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+using std::cout;
+using std::endl;
+
+template <class F>
+vector<F> random_vector(size_t n, std::mt19937_64 &rng) {
+    vector<F> v(n);
+    for (auto &x : v) x = F((size_t)rng());
+    return v;
+}
+
+// forward() must agree with direct evaluation on omega^i, and inverse() must undo it
+template <class F>
+bool test_against_evaluation(std::mt19937_64 &rng) {
+    for (size_t n = 1; n <= 256; n <<= 1) {
+        vector<F> coeffs = random_vector<F>(n, rng);
+        vector<F> values = coeffs;
+        NTT::forward(values);
+        vector<F> expected = BasicPolynomial<F>(coeffs).evaluate_domain(Domain<F>::subgroup(n)->elements());
+        if (values != expected) return false;
+        NTT::inverse(values);
+        if (values != coeffs) return false;
+    }
+    return true;
+}
+
+bool test_bit_reverse() {
+    vector<size_t> v(16);
+    for (size_t i = 0; i != v.size(); i++) v[i] = i;
+    NTT::bit_reverse(std::span<size_t>(v));
+    vector<size_t> expected = {0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15};
+    return v == expected;
+}
+
+// A chunk that throws, on the calling thread or on a worker, must reach the caller only after
+// every other chunk has finished, and leave the pool usable
+bool test_parallel_exceptions() {
+    const size_t threads = parallel::num_threads(), n = 400;
+    parallel::set_num_threads(4);
+    bool ok = true;
+    for (size_t thrower : {0, 100, 300}) {
+        std::atomic<size_t> processed = 0;
+        try {
+            parallel::for_range(n, 1, [&](size_t begin, size_t end) {
+                if (begin == thrower) throw std::runtime_error("chunk failed");
+                for (size_t i = begin; i != end; i++) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(10));
+                    processed++;
+                }
+            });
+            ok = false;
+        } catch (const std::runtime_error&) {
+            ok = ok && processed == n - n / 4;
+        }
+    }
+    std::atomic<size_t> processed = 0;
+    parallel::for_each(n, [&](size_t) { processed++; });
+    parallel::set_num_threads(threads);
+    return ok && processed == n;
+}
+
+// Extension-field vectors over the base subgroup transform coefficient-wise
+template <class F>
+bool test_extension(std::mt19937_64 &rng) {
+    using E = ExtFieldElement<F>;
+    const size_t n = 64;
+    vector<E> values(n);
+    vector<vector<F> > columns(E::degree);
+    for (auto &column : columns) column = random_vector<F>(n, rng);
+    for (size_t i = 0; i != n; i++) {
+        for (size_t k = 0; k != E::degree; k++) values[i].coeffs[k] = columns[k][i];
+    }
+    NTT::forward<E, F>(values);
+    for (size_t k = 0; k != E::degree; k++) {
+        NTT::forward(columns[k]);
+        for (size_t i = 0; i != n; i++) {
+            if (values[i].coeffs[k] != columns[k][i]) return false;
+        }
+    }
+    return true;
+}
+
+// The DIF/DIT pair must agree with forward() up to the bit-reversal permutation, for odd and
+// even log2 n (a trailing radix-2 pass or not) and with the passes split across threads
+template <class T>
+bool test_bit_reversed_pair(std::mt19937_64 &rng) {
+    const size_t threshold = NTT::PARALLEL_THRESHOLD, grain = NTT::PARALLEL_GRAIN, threads = parallel::num_threads();
+    bool ok = true;
+    for (size_t t : {1, 3}) {
+        parallel::set_num_threads(t);
+        NTT::PARALLEL_THRESHOLD = t == 1 ? threshold : 64;
+        NTT::PARALLEL_GRAIN = t == 1 ? grain : 4;
+        for (size_t n = 1; n <= 1024; n <<= 1) {
+            vector<T> values = random_vector<T>(n, rng), expected = values, transformed = values;
+            NTT::forward<T, NTT::twiddle_field_t<T> >(std::span<T>(expected), false);
+            NTT::bit_reverse(std::span<T>(expected));
+            NTT::forward_to_bit_reversed<T>(transformed);
+            ok = ok && transformed == expected;
+            NTT::inverse_from_bit_reversed<T>(transformed);
+            ok = ok && transformed == values;
+        }
+    }
+    parallel::set_num_threads(threads);
+    NTT::PARALLEL_THRESHOLD = threshold;
+    NTT::PARALLEL_GRAIN = grain;
+    return ok;
+}
+
+// The four-step path must match radix-2 exactly, for square and non-square splits and over
+// an extension
+template <class T>
+bool test_four_step(std::mt19937_64 &rng) {
+    using F = NTT::twiddle_field_t<T>;
+    const size_t threshold = NTT::FOUR_STEP_THRESHOLD<F>;
+    NTT::FOUR_STEP_THRESHOLD<F> = 64;
+    bool ok = true;
+    for (size_t n = 64; n <= 2048; n <<= 1) {
+        vector<T> values = random_vector<T>(n, rng), expected = values, transformed = values;
+        NTT::forward<T, NTT::twiddle_field_t<T> >(std::span<T>(expected), false);
+        NTT::forward(transformed);
+        ok = ok && transformed == expected;
+        NTT::inverse(transformed);
+        ok = ok && transformed == values;
+    }
+    NTT::FOUR_STEP_THRESHOLD<F> = threshold;
+    return ok;
+}
+
+// Batched column transforms must be bit-identical to one serial transform per column, for
+// any thread count and with the butterfly stages split across threads
+template <class F>
+bool test_columns(std::mt19937_64 &rng) {
+    const size_t n = 256, threshold = NTT::PARALLEL_THRESHOLD, grain = NTT::PARALLEL_GRAIN, threads = parallel::num_threads();
+    NTT::PARALLEL_THRESHOLD = 64;
+    NTT::PARALLEL_GRAIN = 16;
+    bool ok = true;
+    auto coset = Domain<F>::get(F::generator(), n);
+    for (size_t columns : {1, 3, 8}) {
+        vector<vector<F> > values(columns);
+        vector<F> expected, inverted;
+        for (auto &column : values) {
+            column = random_vector<F>(n, rng);
+            vector<F> transformed = column;
+            NTT::forward<F>(transformed, false);
+            expected.insert(expected.end(), transformed.begin(), transformed.end());
+        }
+        for (size_t t : {1, 2, 4}) {
+            parallel::set_num_threads(t);
+            vector<F> buffer;
+            for (const auto &column : values) buffer.insert(buffer.end(), column.begin(), column.end());
+            NTT::forward_columns<F>(buffer, n);
+            ok = ok && buffer == expected;
+            NTT::inverse_columns<F>(buffer, n);
+            for (size_t c = 0; c != columns; c++) ok = ok && std::equal(values[c].begin(), values[c].end(), buffer.begin() + c * n);
+
+            vector<BasicPolynomial<F> > polys = interpolate_subgroup_columns(*coset, values);
+            vector<vector<F> > codewords = coset_lde_columns(polys, *Domain<F>::get(F::generator(), 4 * n));
+            for (size_t c = 0; c != columns; c++) {
+                ok = ok && polys[c] == interpolate_subgroup(*coset, values[c]);
+                ok = ok && codewords[c] == coset_lde(polys[c], *Domain<F>::get(F::generator(), 4 * n));
+            }
+        }
+    }
+    parallel::set_num_threads(threads);
+    NTT::PARALLEL_THRESHOLD = threshold;
+    NTT::PARALLEL_GRAIN = grain;
+    return ok;
+}
+
+// interpolate_domain must recognize a full subgroup, and interpolate_subgroup must handle cosets
+template <class F>
+bool test_interpolation(std::mt19937_64 &rng) {
+    const size_t n = 32;
+    vector<F> coeffs = random_vector<F>(n, rng);
+    BasicPolynomial<F> poly(coeffs);
+    auto subgroup = Domain<F>::subgroup(n);
+    auto coset = Domain<F>::get(F::generator(), n);
+    if (interpolate_domain(subgroup->elements(), poly.evaluate_domain(subgroup->elements())).coeffs != coeffs) return false;
+    if (interpolate_subgroup(*coset, poly.evaluate_domain(coset->elements())).coeffs != coeffs) return false;
+    // a prefix of a larger subgroup takes the Lagrange path
+    vector<F> prefix(Domain<F>::subgroup(2 * n)->elements().begin(), Domain<F>::subgroup(2 * n)->elements().begin() + n);
+    return interpolate_domain(prefix, poly.evaluate_domain(prefix)) == poly;
+}
+
+// coset_lde must match direct evaluation for every split into small cosets, for the zero
+// polynomial, and when the polynomial is longer than the coset
+template <class F>
+bool test_coset_lde(std::mt19937_64 &rng) {
+    auto coset = Domain<F>::get(F::generator(), 64);
+    for (size_t n : {0, 1, 5, 16, 33, 64, 100}) {
+        BasicPolynomial<F> poly(random_vector<F>(n, rng));
+        if (coset_lde(poly, *coset) != poly.evaluate_domain(coset->elements())) return false;
+    }
+    return true;
+}
+
+// Every tier of the multiplication dispatch must agree with the schoolbook product,
+// including unbalanced operands and lengths that are not powers of two; a second pass recurses
+// Karatsuba down to length 2 to exercise the scratch arena at depth
+template <class T>
+bool test_multiply(std::mt19937_64 &rng) {
+    const size_t threshold = convolution::KARATSUBA_THRESHOLD<T>;
+    bool ok = true;
+    for (size_t cutoff : {threshold, (size_t)2}) {
+        convolution::KARATSUBA_THRESHOLD<T> = cutoff;
+        for (size_t n : {1, 5, 33, 64, 100, 300}) {
+            for (size_t m : {1, 3, 40, 65, 200, 300}) {
+                vector<T> a = random_vector<T>(n, rng), b = random_vector<T>(m, rng);
+                vector<T> expected(n + m - 1);
+                convolution::schoolbook<T>(a, b, expected);
+                ok = ok && convolution::multiply(a, b) == expected;
+                ok = ok && (BasicPolynomial<T>(a) * BasicPolynomial<T>(b)).coeffs == expected;
+            }
+        }
+    }
+    convolution::KARATSUBA_THRESHOLD<T> = threshold;
+    return ok;
+}
+
+// In-place and rvalue operators must agree with the value-returning ones and keep the
+// coefficients trimmed when the leading terms cancel
+template <class F>
+bool test_operators(std::mt19937_64 &rng) {
+    BasicPolynomial<F> a(random_vector<F>(40, rng)), b(random_vector<F>(25, rng));
+    F s = F((size_t)rng());
+    BasicPolynomial<F> sum = a, difference = b, product = a, scaled = b, fused = a;
+    sum += b;
+    difference -= a;
+    product *= b;
+    scaled *= s;
+    axpy(fused, s, b);
+    if (sum != b + a || difference != -(a - b) || product != b * a || scaled != b * BasicPolynomial<F>(s)) return false;
+    if (fused != a + scaled || BasicPolynomial<F>(a) + b != sum || BasicPolynomial<F>(b) * s != scaled) return false;
+    BasicPolynomial<F> cancelled = a;
+    cancelled -= a;
+    axpy(fused, -s, b);
+    return cancelled.degree() == -1 && cancelled.coeffs.empty() && fused == a && (a * F(0)).degree() == -1;
+}
+
+// Long division and Newton division, fresh or through a reusable Divisor, must reconstruct the
+// dividend with a remainder of smaller degree
+template <class F>
+bool check_division(std::mt19937_64 &rng) {
+    for (size_t n : {1, 10, 100, 300, 1000}) {
+        for (size_t m : {1, 2, 65, 200}) {
+            BasicPolynomial<F> a(random_vector<F>(n, rng)), b(random_vector<F>(m, rng));
+            BasicPolynomial<F> q, r;
+            a.divided_by(b, q, r);
+            if (r.degree() >= b.degree() || q * b + r != a) return false;
+            division::Divisor<F> divisor(b.coeffs);
+            BasicPolynomial<F> q2, r2;
+            a.divided_by(divisor, q2, r2);
+            if (q2 != q || r2 != r) return false;
+            vector<F> in_place = a.coeffs;
+            division::long_division<F>(in_place, b.coeffs);
+            if (n >= m && BasicPolynomial<F>(vector<F>(in_place.begin() + (m - 1), in_place.end())) != q) return false;
+        }
+    }
+    BasicPolynomial<F> b(random_vector<F>(150, rng)), c(random_vector<F>(400, rng));
+    return (b * c) / division::Divisor<F>(b.coeffs) == c && (b * c) / c == b;
+}
+
+// Once at the default crossover and once low enough that the Newton path runs at these sizes
+template <class F>
+bool test_division(std::mt19937_64 &rng) {
+    const size_t threshold = division::NEWTON_THRESHOLD<F>;
+    bool ok = check_division<F>(rng);
+    division::NEWTON_THRESHOLD<F> = 32;
+    ok = ok && check_division<F>(rng);
+    division::NEWTON_THRESHOLD<F> = threshold;
+    return ok;
+}
+
+// Sparse polynomials against their dense expansion, and the closed-form subgroup zerofier
+// against the product of its linear factors, with a few points excluded and with half the subgroup
+template <class F>
+bool test_sparse(std::mt19937_64 &rng) {
+    auto coset = Domain<F>::get(F::generator(), 64);
+    vector<F> c = random_vector<F>(3, rng);
+    SparsePolynomial<F> sparse({{40, c[0]}, {0, c[1]}, {7, c[2]}, {7, -c[2]}, {3, F(1)}});
+    if (sparse.terms.size() != 3 || sparse.degree() != 40) return false;
+    BasicPolynomial<F> dense = sparse.dense();
+    if (sparse.evaluate_domain(*coset) != dense.evaluate_domain(coset->elements())) return false;
+    if (sparse[F(12345)] != dense[F(12345)]) return false;
+    for (size_t n : {1, 30, 200}) {
+        BasicPolynomial<F> a(random_vector<F>(n, rng));
+        if (a * sparse != a * dense) return false;
+        BasicPolynomial<F> q, r, q2, r2;
+        divided_by(a, sparse, q, r);
+        a.divided_by(dense, q2, r2);
+        if (q != q2 || r != r2) return false;
+    }
+
+    const size_t n = 16;
+    auto subgroup = Domain<F>::subgroup(n);
+    vector<F> kept(subgroup->elements().begin(), subgroup->elements().end() - 3);
+    vector<F> excluded(subgroup->elements().end() - 3, subgroup->elements().end());
+    SubgroupZerofier<F> zerofier(n, excluded);
+    BasicPolynomial<F> expected = zerofier_domain(kept);
+    if (zerofier.dense() != expected || zerofier[F(12345)] != expected[F(12345)]) return false;
+    if (SparsePolynomial<F>::subgroup_zerofier(n).dense() / expected != zerofier_domain(excluded)) return false;
+    vector<F> inverses = expected.evaluate_domain(coset->elements());
+    batch_inverse(inverses);
+    if (zerofier.inverse_codeword(*coset) != inverses) return false;
+
+    // Half the subgroup excluded, on cosets smaller and larger than the excluded factor
+    const size_t big = 1024;
+    auto big_subgroup = Domain<F>::subgroup(big);
+    vector<F> big_kept(big_subgroup->elements().begin(), big_subgroup->elements().begin() + big / 2);
+    vector<F> big_excluded(big_subgroup->elements().begin() + big / 2, big_subgroup->elements().end());
+    SubgroupZerofier<F> big_zerofier(big, big_excluded);
+    BasicPolynomial<F> big_expected = zerofier_domain(big_kept);
+    for (size_t size : {256, 4096}) {
+        auto big_coset = Domain<F>::get(F::generator(), size);
+        vector<F> big_inverses = big_expected.evaluate_domain(big_coset->elements());
+        batch_inverse(big_inverses);
+        if (big_zerofier.inverse_codeword(*big_coset) != big_inverses) return false;
+    }
+    return true;
+}
+
+// Subproduct-tree evaluation, interpolation and zerofier on random (non-subgroup) points,
+// at sizes below and above the delegation threshold
+template <class F>
+bool test_subproduct_tree(std::mt19937_64 &rng) {
+    for (size_t n : {1, 17, 100, 257}) {
+        vector<F> points = random_vector<F>(n, rng);
+        BasicPolynomial<F> poly(random_vector<F>(n + 30, rng));
+        SubproductTree<F> tree(points);
+        vector<F> values = poly.evaluate_domain(points);
+        if (tree.evaluate(poly) != values) return false;
+
+        BasicPolynomial<F> zerofier = zerofier_domain(points);
+        if (zerofier != tree.zerofier() || zerofier.degree() != (int64_t)n) return false;
+        for (const auto &v : zerofier.evaluate_domain(points)) {
+            if (v != F(0)) return false;
+        }
+
+        BasicPolynomial<F> interpolant = interpolate_domain(points, values);
+        if (interpolant.degree() >= (int64_t)n || interpolant.evaluate_domain(points) != values) return false;
+        if (interpolant != poly % zerofier) return false;
+    }
+    return true;
+}
+
+template <class F>
+void run(const string &name, std::mt19937_64 &rng) {
+    cout << name << endl;
+    cout << "  NTT against evaluation: " << (test_against_evaluation<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Bit-reversed DIF/DIT pair: " << (test_bit_reversed_pair<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Four-step NTT: " << (test_four_step<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Batched columns: " << (test_columns<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Subgroup interpolation: " << (test_interpolation<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Coset LDE: " << (test_coset_lde<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Multiplication dispatch: " << (test_multiply<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Polynomial operators: " << (test_operators<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Division: " << (test_division<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Sparse polynomials: " << (test_sparse<F>(rng) ? "pass" : "fail") << endl;
+    cout << "  Subproduct tree: " << (test_subproduct_tree<F>(rng) ? "pass" : "fail") << endl;
+    if constexpr (F::params::ext_degree > 1) {
+        cout << "  NTT over the extension: " << (test_extension<F>(rng) ? "pass" : "fail") << endl;
+        cout << "  DIF/DIT pair over the extension: " << (test_bit_reversed_pair<ExtFieldElement<F> >(rng) ? "pass" : "fail") << endl;
+        cout << "  Four-step NTT over the extension: " << (test_four_step<ExtFieldElement<F> >(rng) ? "pass" : "fail") << endl;
+        cout << "  Multiplication over the extension: " << (test_multiply<ExtFieldElement<F> >(rng) ? "pass" : "fail") << endl;
+    }
+}
+
+int main() {
+    std::mt19937_64 rng(7);
+    cout << "Bit reversal: " << (test_bit_reverse() ? "pass" : "fail") << endl;
+    cout << "Exceptions in parallel loops: " << (test_parallel_exceptions() ? "pass" : "fail") << endl;
+    run<FieldElement>("p = 1 + 407 * 2^119", rng);
+    run<GoldilocksElement>("Goldilocks", rng);
+    run<BabyBearElement>("BabyBear", rng);
+}